@@ -1,5 +1,11 @@
 QT+=opengl
 LIBS+=-lGLU
+LIBS+=-lrt
+CONFIG+=thread
+# Remove to compile out per-phase timing
+DEFINES+=ENABLE_PHASE_TIMING
+# Debug builds check that update phases running concurrently never access the same data, see TaskGraph.h
+CONFIG(debug, debug|release): DEFINES+=ENABLE_TASK_VALIDATION
 TEMPLATE = app
 TARGET = ./bin/basic-flight
 INCLUDEPATH += ./src
@@ -14,25 +20,77 @@ MOC_DIR=./build/moc
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 # Input
-HEADERS += src/Cartesian3.h \
+HEADERS += src/AircraftStore.h \
+           src/AllocationCounter.h \
+           src/BoundingVolumeHierarchy.h \
+           src/Cartesian3.h \
+           src/CommandLine.h \
+           src/ControlInput.h \
+           src/ConvexCollision.h \
+           src/ConvexHull.h \
            src/FlightSimulatorWidget.h \
+           src/FrameArena.h \
+           src/FrameBudgetGovernor.h \
+           src/FramePacing.h \
+           src/HeldControls.h \
            src/Homogeneous4.h \
            src/HomogeneousFaceSurface.h \
+           src/IndexedMesh.h \
+           src/InputRecording.h \
            src/LavaBombParticle.h \
+           src/LockFreeQueue.h \
            src/Matrix4.h \
+           src/MemoryReport.h \
+           src/ObstacleLayer.h \
+           src/PerformanceCounters.h \
+           src/PhaseTimer.h \
            src/Random.h \
            src/Scene.h \
+           src/SceneAssets.h \
+           src/SceneSnapshot.h \
+           src/SceneState.h \
+           src/SimulationThread.h \
            src/SphereCollision.h \
-           src/Terrain.h
+           src/TaskGraph.h \
+           src/TelemetryRing.h \
+           src/Terrain.h \
+           src/TextScanner.h \
+           src/TraceEvents.h \
+           src/TripleBuffer.h \
+           src/WorkStealingPool.h
 
-SOURCES += src/Cartesian3.cpp \
+SOURCES += src/AircraftStore.cpp \
+           src/AllocationCounter.cpp \
+           src/BoundingVolumeHierarchy.cpp \
+           src/Cartesian3.cpp \
+           src/CommandLine.cpp \
+           src/ControlInput.cpp \
+           src/ConvexCollision.cpp \
+           src/ConvexHull.cpp \
            src/FlightSimulatorWidget.cpp \
+           src/FrameArena.cpp \
+           src/FrameBudgetGovernor.cpp \
+           src/FramePacing.cpp \
+           src/HeldControls.cpp \
            src/Homogeneous4.cpp \
            src/HomogeneousFaceSurface.cpp \
+           src/IndexedMesh.cpp \
+           src/InputRecording.cpp \
            src/LavaBombParticle.cpp \
            src/main.cpp \
            src/Matrix4.cpp \
+           src/MemoryReport.cpp \
+           src/ObstacleLayer.cpp \
+           src/PerformanceCounters.cpp \
+           src/PhaseTimer.cpp \
            src/Random.cpp \
            src/Scene.cpp \
+           src/SceneAssets.cpp \
+           src/SimulationThread.cpp \
            src/SphereCollision.cpp \
-           src/Terrain.cpp
+           src/TaskGraph.cpp \
+           src/TelemetryRing.cpp \
+           src/Terrain.cpp \
+           src/TextScanner.cpp \
+           src/TraceEvents.cpp \
+           src/WorkStealingPool.cpp
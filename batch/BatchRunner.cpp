@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Cartesian3.h"
+#include "CommandLine.h"
+#include "ControlScript.h"
+#include "Random.h"
+#include "Scene.h"
+#include "SceneAssets.h"
+#include "SimulationThread.h"
+#include "WorkStealingPool.h"
+
+/*
+ * Runs many independent flights concurrently, e.g. for Monte Carlo sweeps over start positions and seeds.
+ * Assets are loaded once and shared read-only by every Scene, runs are spread over a work-stealing pool.
+ * Run from the repository root so that assets resolve.
+ */
+
+constexpr unsigned int defaultRuns = 1000;
+// 1 minute of simulated time
+constexpr unsigned long defaultTicks = 3600;
+
+// Flights start this high above the terrain, measured in meters
+constexpr float minimumStartAltitude = 200.0f;
+constexpr float maximumStartAltitude = 2000.0f;
+
+typedef std::chrono::steady_clock Clock;
+
+struct RunOutcome {
+    std::uint32_t seed = 0;
+    Cartesian3 initialPosition;
+    // Ticks simulated, up to the crash if any
+    unsigned long ticks = 0;
+    CrashCause crashCause = CrashCause::None;
+    // Measured in seconds
+    double wallTime = 0.0;
+};
+
+void printUsage() {
+    std::cerr << "Usage: basic-flight-batch [options]" << std::endl;
+    std::cerr << "  --runs <n>             flights to simulate (default: " << defaultRuns << ")" << std::endl;
+    std::cerr << "  --ticks <n>            ticks per flight, unless it crashes first (default: " << defaultTicks << ")"
+            << std::endl;
+    std::cerr << "  --threads <n>          worker threads (default: one per hardware thread)" << std::endl;
+    std::cerr << "  --seed <n>             seed of the sweep, each flight gets its own (default: drawn at random)"
+            << std::endl;
+    std::cerr << "  --script <file>        control script applied to every flight" << std::endl;
+    std::cerr << "  --obstacles <file>     .obs file of static obstacles" << std::endl;
+    std::cerr << "  --aircraft <n>         aircraft flying besides the player's, in every flight" << std::endl;
+    std::cerr << "  --output <file>        writes every flight's outcome as CSV" << std::endl;
+}
+
+// Start positions over random points of the terrain, drawn from the sweep's seed
+std::vector<Cartesian3> drawStartPositions(const Terrain& terrain, Random& random, const unsigned int count) {
+    const float halfWidth = terrain.xyScale * static_cast<float>(terrain.heightValues[0].size()) / 2.0f;
+    const float halfHeight = terrain.xyScale * static_cast<float>(terrain.heightValues.size()) / 2.0f;
+
+    std::vector<Cartesian3> positions;
+    while (positions.size() < count) {
+        Cartesian3 position(random.range(-halfWidth, halfWidth), random.range(-halfHeight, halfHeight), 0.0f);
+        if (!terrain.contains(position.x, position.y)) {
+            continue;
+        }
+
+        position.z = terrain.getHeight(position.x, position.y) +
+                     random.range(minimumStartAltitude, maximumStartAltitude);
+        positions.push_back(position);
+    }
+    return positions;
+}
+
+void writeOutcomes(std::ostream& outStream, const std::vector<RunOutcome>& outcomes) {
+    outStream << "run,seed,x,y,z,ticks,crash_time_s,cause,wall_ms" << std::endl;
+    for (std::size_t run = 0; run < outcomes.size(); run++) {
+        const RunOutcome& outcome = outcomes[run];
+        outStream << run << "," << outcome.seed << ","
+                  << outcome.initialPosition.x << "," << outcome.initialPosition.y << ","
+                  << outcome.initialPosition.z << "," << outcome.ticks << ",";
+        if (outcome.crashCause != CrashCause::None) {
+            outStream << outcome.ticks * simulationTimeStep;
+        }
+        outStream << "," << crashCauseNames[static_cast<std::size_t>(outcome.crashCause)] << ","
+                  << 1000.0 * outcome.wallTime << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (!hasWellFormedOptionalParameters(argc, argv, 1)) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    const char* runsParameter = optionalParameter(argc, argv, 1, "runs");
+    const char* ticksParameter = optionalParameter(argc, argv, 1, "ticks");
+    const char* threadsParameter = optionalParameter(argc, argv, 1, "threads");
+    const char* seedParameter = optionalParameter(argc, argv, 1, "seed");
+    const char* scriptParameter = optionalParameter(argc, argv, 1, "script");
+    const char* obstacleFileName = optionalParameter(argc, argv, 1, "obstacles");
+    const char* aircraftParameter = optionalParameter(argc, argv, 1, "aircraft");
+    const char* outputFileName = optionalParameter(argc, argv, 1, "output");
+
+    const unsigned int nRuns = runsParameter ? std::strtoul(runsParameter, nullptr, 10) : defaultRuns;
+    const unsigned long nTicks = ticksParameter ? std::strtoul(ticksParameter, nullptr, 10) : defaultTicks;
+    const unsigned int nThreads = threadsParameter ? std::strtoul(threadsParameter, nullptr, 10) : 0;
+    const std::uint32_t sweepSeed = seedParameter ? std::strtoul(seedParameter, nullptr, 10) : std::random_device()();
+    const unsigned int nAircraft = aircraftParameter ? std::strtoul(aircraftParameter, nullptr, 10) : 0;
+
+    try {
+        const Clock::time_point loadStart = Clock::now();
+        const auto assets = std::make_shared<const SceneAssets>(obstacleFileName);
+        const double loadTime = std::chrono::duration<double>(Clock::now() - loadStart).count();
+
+        ControlScript script;
+        if (scriptParameter && !script.readControlScriptFile(scriptParameter)) {
+            std::cerr << "Unable to read control script " << scriptParameter << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        Random random(sweepSeed);
+        const std::vector<Cartesian3> startPositions = drawStartPositions(assets->terrain, random, nRuns);
+
+        // Written by one task each, read once the pool is done
+        std::vector<RunOutcome> outcomes(nRuns);
+
+        WorkStealingPool pool(nThreads);
+
+        const Clock::time_point runStart = Clock::now();
+        for (unsigned int run = 0; run < nRuns; run++) {
+            pool.submit([&, run] {
+                const Clock::time_point start = Clock::now();
+
+                RunOutcome& outcome = outcomes[run];
+                outcome.seed = sweepSeed + run;
+                outcome.initialPosition = startPositions[run];
+
+                Scene scene(assets, outcome.initialPosition, outcome.seed);
+                scene.spawnAircraft(nAircraft);
+
+                ControlScript flightScript = script;
+                while (scene.ticks < nTicks && !scene.shouldExit) {
+                    flightScript.applyDue(scene);
+                    scene.update(simulationTimeStep);
+                }
+
+                outcome.ticks = scene.ticks;
+                outcome.crashCause = scene.crashCause;
+                outcome.wallTime = std::chrono::duration<double>(Clock::now() - start).count();
+            });
+        }
+        pool.wait();
+        const double runTime = std::chrono::duration<double>(Clock::now() - runStart).count();
+
+        unsigned long totalTicks = 0;
+        std::vector<unsigned int> crashes(crashCauseNames.size(), 0);
+        double slowestRun = 0.0;
+        for (const RunOutcome& outcome : outcomes) {
+            totalTicks += outcome.ticks;
+            crashes[static_cast<std::size_t>(outcome.crashCause)]++;
+            slowestRun = std::max(slowestRun, outcome.wallTime);
+        }
+
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "seed:               " << sweepSeed << std::endl;
+        std::cout << "load:               " << 1000.0 * loadTime << " ms, once for every run" << std::endl;
+        assets->printLoadTimes(std::cout);
+        std::cout << "runs:               " << nRuns << " on " << pool.threadCount() << " threads" << std::endl;
+        std::cout << "run:                " << 1000.0 * runTime << " ms" << std::endl;
+        std::cout << "runs per second:    " << nRuns / runTime << std::endl;
+        std::cout << "ticks per second:   " << totalTicks / runTime << " (" << totalTicks << " ticks)" << std::endl;
+        std::cout << "slowest run:        " << 1000.0 * slowestRun << " ms" << std::endl;
+        std::cout << "outcomes:" << std::endl;
+        for (std::size_t cause = 0; cause < crashCauseNames.size(); cause++) {
+            std::cout << "  " << std::left << std::setw(18) << crashCauseNames[cause] << std::right
+                    << std::setw(8) << crashes[cause] << std::endl;
+        }
+
+        std::cout << "per-thread runs, stolen:" << std::endl;
+        const std::vector<WorkerStatistics> statistics = pool.statistics();
+        for (std::size_t worker = 0; worker < statistics.size(); worker++) {
+            std::cout << "  " << std::left << std::setw(18) << worker << std::right
+                    << std::setw(8) << statistics[worker].executed << std::setw(8) << statistics[worker].stolen
+                    << std::endl;
+        }
+
+        if (outputFileName) {
+            std::ofstream outFile(outputFileName);
+            writeOutcomes(outFile, outcomes);
+            if (!outFile.good()) {
+                std::cerr << "Unable to write outcomes to " << outputFileName << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        return EXIT_SUCCESS;
+    } catch (std::string errorString) {
+        std::cout << "Unable to run batch. " << errorString << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,40 @@
+TEMPLATE = app
+CONFIG += console release c++17 thread
+CONFIG -= qt app_bundle
+# Scene links against OpenGL for rendering, which batch runs never call
+LIBS += -lGL -lGLU
+TARGET = ../bin/basic-flight-batch
+INCLUDEPATH += ../src
+OBJECTS_DIR = ../build/batch/obj
+
+# Input
+SOURCES += BatchRunner.cpp \
+           ../src/AircraftStore.cpp \
+           ../src/AllocationCounter.cpp \
+           ../src/BoundingVolumeHierarchy.cpp \
+           ../src/Cartesian3.cpp \
+           ../src/CommandLine.cpp \
+           ../src/ControlInput.cpp \
+           ../src/ControlScript.cpp \
+           ../src/ConvexCollision.cpp \
+           ../src/ConvexHull.cpp \
+           ../src/FrameArena.cpp \
+           ../src/Homogeneous4.cpp \
+           ../src/HomogeneousFaceSurface.cpp \
+           ../src/IndexedMesh.cpp \
+           ../src/InputRecording.cpp \
+           ../src/LavaBombParticle.cpp \
+           ../src/Matrix4.cpp \
+           ../src/MemoryReport.cpp \
+           ../src/ObstacleLayer.cpp \
+           ../src/PerformanceCounters.cpp \
+           ../src/PhaseTimer.cpp \
+           ../src/Random.cpp \
+           ../src/Scene.cpp \
+           ../src/SceneAssets.cpp \
+           ../src/SphereCollision.cpp \
+           ../src/TaskGraph.cpp \
+           ../src/Terrain.cpp \
+           ../src/TextScanner.cpp \
+           ../src/TraceEvents.cpp \
+           ../src/WorkStealingPool.cpp
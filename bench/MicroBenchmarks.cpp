@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "Cartesian3.h"
+#include "Homogeneous4.h"
+#include "HomogeneousFaceSurface.h"
+#include "IndexedMesh.h"
+#include "Matrix4.h"
+#include "Random.h"
+#include "Scene.h"
+#include "SceneAssets.h"
+#include "SimulationThread.h"
+#include "SphereCollision.h"
+#include "Terrain.h"
+
+/*
+ * Times the math, terrain, collision, loading and update hot paths, one benchmark at a time.
+ * Results are printed as a table and written as JSON, so that runs can be compared to catch regressions.
+ * Run from the repository root so that assets resolve.
+ *
+ * Usage: bin/micro-benchmarks [output.json = micro-benchmarks.json] [name filter]
+ */
+
+const std::string terrainName = "assets/landscape.dem";
+const std::string planeModelName = "assets/planeModel.tri";
+
+// Samples per benchmark, reported as the fastest and the median
+constexpr int samplesPerBenchmark = 9;
+
+// Inputs are cycled through, sized to stay in cache except where a benchmark is about memory
+constexpr std::size_t inputCount = 4096;
+
+// Ticks simulated before timing Scene::update, 20 simulated seconds
+constexpr long steadyStateTicks = 1200;
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchmarkResult {
+    std::string name;
+    long operationsPerSample;
+    // Measured in nanoseconds per operation
+    double minimum;
+    double median;
+    // Heap allocations per operation, averaged over the samples, 0 unless built with ENABLE_ALLOCATION_COUNTING
+    double allocations;
+};
+
+// Defeats dead code elimination of results nothing else reads
+volatile float benchmarkSink;
+
+// run(operations) performs operations operations and returns a value depending on all of them
+template <typename Function>
+BenchmarkResult runBenchmark(const std::string& name, const long operationsPerSample, Function run) {
+    // Warm caches & branch predictors
+    benchmarkSink = run(operationsPerSample);
+
+    std::vector<double> sampleTimes;
+    sampleTimes.reserve(samplesPerBenchmark);
+    const AllocationCount allocationsBefore = threadAllocationCount();
+    for (int sample = 0; sample < samplesPerBenchmark; sample++) {
+        const Clock::time_point start = Clock::now();
+        benchmarkSink = run(operationsPerSample);
+        sampleTimes.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                              operationsPerSample);
+    }
+
+    const auto sampleAllocations = threadAllocationCount().allocations - allocationsBefore.allocations;
+    const double allocations = static_cast<double>(sampleAllocations) / (operationsPerSample * samplesPerBenchmark);
+
+    std::sort(sampleTimes.begin(), sampleTimes.end());
+    return {name, operationsPerSample, sampleTimes.front(), sampleTimes[sampleTimes.size() / 2], allocations};
+}
+
+void writeJson(std::ostream& outStream, const std::vector<BenchmarkResult>& results) {
+    outStream << std::setprecision(6);
+    outStream << "{\n  \"unit\": \"ns/op\",\n  \"samples\": " << samplesPerBenchmark << ",\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& result = results[i];
+        outStream << "    {\"name\": \"" << result.name << "\", \"operations\": " << result.operationsPerSample
+                  << ", \"min\": " << result.minimum << ", \"median\": " << result.median
+                  << ", \"allocations\": " << result.allocations << "}"
+                  << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    outStream << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    const char* outputFileName = argc > 1 ? argv[1] : "micro-benchmarks.json";
+    const std::string filter = argc > 2 ? argv[2] : "";
+
+    std::vector<BenchmarkResult> results;
+    const auto benchmark = [&](const std::string& name, const long operationsPerSample, auto run) {
+        if (name.find(filter) == std::string::npos) {
+            return;
+        }
+        results.push_back(runBenchmark(name, operationsPerSample, run));
+        const BenchmarkResult& result = results.back();
+        std::cout << std::left << std::setw(46) << result.name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << result.minimum << std::setw(14) << result.median
+                  << std::setw(14) << result.allocations << std::endl;
+    };
+
+    std::cout << std::left << std::setw(46) << "benchmark" << std::right
+              << std::setw(14) << "min ns/op" << std::setw(14) << "median ns/op" << std::setw(14) << "allocs/op"
+              << std::endl;
+
+    Random random(1);
+
+    std::vector<Matrix4> matrices(inputCount);
+    std::vector<Homogeneous4> points(inputCount);
+    std::vector<Cartesian3> centers(inputCount);
+    for (std::size_t i = 0; i < inputCount; i++) {
+        matrices[i] = Matrix4::rotationX(random.range(0.0f, 360.0f)) * Matrix4::rotationZ(random.range(0.0f, 360.0f)) *
+                      Matrix4::translation(random.vector(-1000.0f, 1000.0f));
+        points[i] = Homogeneous4(random.vector(-1000.0f, 1000.0f));
+        centers[i] = random.vector(-1000.0f, 1000.0f);
+    }
+
+    // Math
+    benchmark("Matrix4::operator*(Matrix4)", 1 << 20, [&](const long operations) {
+        Matrix4 product = Matrix4::identity();
+        for (long i = 0; i < operations; i++) {
+            product = matrices[i % inputCount] * product;
+        }
+        return product[0][0];
+    });
+
+    benchmark("Matrix4::transpose", 1 << 20, [&](const long operations) {
+        float sum = 0.0f;
+        for (long i = 0; i < operations; i++) {
+            sum += matrices[i % inputCount].transpose()[0][1];
+        }
+        return sum;
+    });
+
+    benchmark("Matrix4::operator*(Homogeneous4)", 1 << 22, [&](const long operations) {
+        float sum = 0.0f;
+        for (long i = 0; i < operations; i++) {
+            sum += (matrices[i % inputCount] * points[(i * 7) % inputCount]).x;
+        }
+        return sum;
+    });
+
+    // Collision
+    benchmark("isSphereSphereCollision", 1 << 22, [&](const long operations) {
+        int hits = 0;
+        for (long i = 0; i < operations; i++) {
+            hits += isSphereSphereCollision(centers[i % inputCount], 100.0f, centers[(i * 7 + 1) % inputCount], 100.0f);
+        }
+        return static_cast<float>(hits);
+    });
+
+    // Loading
+    benchmark("Terrain::readTerrainFile", 3, [&](const long operations) {
+        float sum = 0.0f;
+        for (long i = 0; i < operations; i++) {
+            Terrain loadedTerrain;
+            loadedTerrain.readTerrainFile(terrainName.data(), 500);
+            sum += loadedTerrain.maximumSlope;
+        }
+        return sum;
+    });
+
+    benchmark("HomogeneousFaceSurface::readTriangleSoupFile", 100, [&](const long operations) {
+        float sum = 0.0f;
+        for (long i = 0; i < operations; i++) {
+            HomogeneousFaceSurface model;
+            model.readTriangleSoupFile(planeModelName.data());
+            sum += model.mesh.positions.empty() ? 0.0f : model.mesh.positions[0].x;
+        }
+        return sum;
+    });
+
+    // A 2048 x 2048 DEM's worth of height values, large enough to be parsed on several threads
+    std::string largeHeightValues;
+    for (long row = 0; row < 2048; row++) {
+        for (long col = 0; col < 2048; col++) {
+            largeHeightValues += '\t' + std::to_string((row * 31 + col * 17) % 2048);
+        }
+        largeHeightValues += '\n';
+    }
+    benchmark("parseHeightValues/2048x2048", 1, [&](const long operations) {
+        float sum = 0.0f;
+        for (long i = 0; i < operations; i++) {
+            std::vector<float> values;
+            parseHeightValues(largeHeightValues.data(), largeHeightValues.data() + largeHeightValues.size(), values);
+            sum += values.back();
+        }
+        return sum;
+    });
+
+    benchmark("SceneAssets::SceneAssets", 3, [&](const long operations) {
+        float sum = 0.0f;
+        for (long i = 0; i < operations; i++) {
+            const SceneAssets assets;
+            sum += assets.terrain.maximumSlope;
+        }
+        return sum;
+    });
+
+    Terrain terrain;
+    if (!terrain.readTerrainFile(terrainName.data(), 500)) {
+        std::cerr << "Unable to read " << terrainName << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Vertex cache ordering & normals of the whole heightfield, already in order, which costs about the same
+    benchmark("IndexedMesh::build/terrain", 3, [&](const long operations) {
+        float sum = 0.0f;
+        for (long i = 0; i < operations; i++) {
+            IndexedMesh mesh;
+            mesh.build(terrain.mesh.positions, terrain.mesh.indices);
+            sum += mesh.normals[0].u;
+        }
+        return sum;
+    });
+
+    // Terrain queries, keeping away from the edges where getHeight is not defined
+    const float halfWidth = 0.45f * terrain.xyScale * terrain.heightValues[0].size();
+    const float halfHeight = 0.45f * terrain.xyScale * terrain.heightValues.size();
+
+    // Scattered over the whole heightfield, as lava bomb landing predictions are
+    std::vector<Cartesian3> scatteredQueries(1 << 16);
+    for (auto& query : scatteredQueries) {
+        query = Cartesian3(random.range(-halfWidth, halfWidth), random.range(-halfHeight, halfHeight), 0.0f);
+    }
+
+    // Along a straight path in steps of a few meters, as the plane's are
+    std::vector<Cartesian3> coherentQueries(1 << 16);
+    for (std::size_t i = 0; i < coherentQueries.size(); i++) {
+        const float t = static_cast<float>(i) / coherentQueries.size();
+        coherentQueries[i] = Cartesian3(-halfWidth + t * halfWidth, -halfHeight + t * halfHeight, 0.0f);
+    }
+
+    benchmark("Terrain::getHeight/scattered", 1 << 22, [&](const long operations) {
+        float sum = 0.0f;
+        for (long i = 0; i < operations; i++) {
+            const Cartesian3& query = scatteredQueries[i % scatteredQueries.size()];
+            sum += terrain.getHeight(query.x, query.y);
+        }
+        return sum;
+    });
+
+    benchmark("Terrain::getHeight/coherent", 1 << 22, [&](const long operations) {
+        float sum = 0.0f;
+        for (long i = 0; i < operations; i++) {
+            const Cartesian3& query = coherentQueries[i % coherentQueries.size()];
+            sum += terrain.getHeight(query.x, query.y);
+        }
+        return sum;
+    });
+
+    // Update, with lava bombs topped up before every tick so that the count holds as they land
+    // Spawning, i.e. predicting landings, is part of the measured cost as it is in a steady stream of explosions
+    for (const unsigned int nLavaBombs : {0u, 100u, 500u, 1000u}) {
+        const std::string name = "Scene::update/bombs:" + std::to_string(nLavaBombs);
+        if (name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        Scene scene(Cartesian3(0.0f, 0.0f, 5000.0f), nullptr, 1);
+        scene.lavaBombBudget.maximumLiveLavaBombs = nLavaBombs;
+        scene.lavaBombBudget.spawnInterval = 0.0f;
+        scene.spawnLavaBombs(nLavaBombs);
+
+        const auto run = [&](const long operations) {
+            for (long i = 0; i < operations; i++) {
+                if (scene.liveLavaBombs() < nLavaBombs) {
+                    scene.spawnLavaBombs(nLavaBombs - scene.liveLavaBombs());
+                }
+                scene.update(simulationTimeStep);
+            }
+            return static_cast<float>(scene.liveLavaBombs());
+        };
+
+        // Until lava bombs are spread over their whole flight rather than bunched at the volcano
+        run(steadyStateTicks);
+
+        benchmark(name, nLavaBombs > 100 ? 100 : 1000, run);
+    }
+
+    // Update with aircraft besides the player's, topped up as they crash, and the default lava bomb load
+    for (const unsigned int nAircraft : {100u, 1000u}) {
+        const std::string name = "Scene::update/aircraft:" + std::to_string(nAircraft);
+        if (name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        Scene scene(Cartesian3(0.0f, 0.0f, 5000.0f), nullptr, 1);
+        scene.spawnAircraft(nAircraft);
+
+        const auto run = [&](const long operations) {
+            for (long i = 0; i < operations; i++) {
+                if (scene.aircraft.size() < nAircraft) {
+                    scene.spawnAircraft(static_cast<unsigned int>(nAircraft - scene.aircraft.size()));
+                }
+                scene.update(simulationTimeStep);
+            }
+            return static_cast<float>(scene.aircraft.size());
+        };
+
+        run(steadyStateTicks);
+
+        benchmark(name, 1000, run);
+    }
+
+    std::ofstream outFile(outputFileName);
+    writeJson(outFile, results);
+    if (!outFile.good()) {
+        std::cerr << "Unable to write " << outputFileName << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "Results written to " << outputFileName << std::endl;
+
+    return EXIT_SUCCESS;
+}
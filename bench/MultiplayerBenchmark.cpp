@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CommandLine.h"
+#include "MultiplayerClient.h"
+#include "MultiplayerServer.h"
+#include "Random.h"
+#include "Scene.h"
+#include "SimulationThread.h"
+
+/*
+ * Runs a MultiplayerServer in real time with clients on threads of their own, all over loopback UDP,
+ * and reports the bandwidth snapshots take and the latency from sending them to decoding them.
+ * Run from the repository root so that assets resolve.
+ */
+
+constexpr unsigned int defaultClients = 32;
+constexpr double defaultSeconds = 5.0;
+constexpr unsigned int defaultAircraft = 100;
+constexpr unsigned int defaultBombs = 200;
+
+// Clients resend their join request this often until welcomed, measured in milliseconds
+constexpr int joinRetryInterval = 100;
+
+// Clients change their steering about this often, measured in snapshots received
+constexpr unsigned long steeringInterval = 120;
+
+typedef std::chrono::steady_clock Clock;
+
+void printUsage() {
+    std::cerr << "Usage: multiplayer-benchmark [options]" << std::endl;
+    std::cerr << "  --clients <n>          clients, each flying an aircraft (default: " << defaultClients << ")"
+            << std::endl;
+    std::cerr << "  --seconds <s>          real time to run the server for (default: " << defaultSeconds << ")"
+            << std::endl;
+    std::cerr << "  --aircraft <n>         aircraft flying besides the clients' (default: " << defaultAircraft << ")"
+            << std::endl;
+    std::cerr << "  --bombs <n>            lava bombs spawned upfront, also the live lava bomb limit (default: "
+            << defaultBombs << ")" << std::endl;
+}
+
+// Joins, then steers at random and acknowledges every snapshot received until stop is set
+void runClient(MultiplayerClient& client, const UdpAddress& server, const std::uint32_t seed,
+               const std::atomic<bool>& stop) {
+    Random random(seed);
+    if (!client.open(server)) {
+        return;
+    }
+
+    Clock::time_point lastJoin = Clock::now();
+    float speed = random.range(1.0f, static_cast<float>(maxFlightSpeed));
+    float turn = 0.0f;
+    while (!stop.load(std::memory_order_relaxed)) {
+        if (!client.joined && Clock::now() - lastJoin > std::chrono::milliseconds(joinRetryInterval)) {
+            client.join();
+            lastJoin = Clock::now();
+        }
+
+        if (!client.wait(10) || client.receive() == 0 || !client.joined) {
+            continue;
+        }
+
+        if (client.statistics.snapshotsReceived % steeringInterval == 0) {
+            speed = random.range(1.0f, static_cast<float>(maxFlightSpeed));
+            turn = random.range(-1.0f, 1.0f);
+        }
+        client.sendInput(speed, 0.0f, turn);
+    }
+}
+
+float percentile(std::vector<float>& values, const float fraction) {
+    if (values.empty()) {
+        return 0.0f;
+    }
+    const std::size_t index = std::min(values.size() - 1, static_cast<std::size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char** argv) {
+    if (!hasWellFormedOptionalParameters(argc, argv, 1)) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    const char* clientsParameter = optionalParameter(argc, argv, 1, "clients");
+    const char* secondsParameter = optionalParameter(argc, argv, 1, "seconds");
+    const char* aircraftParameter = optionalParameter(argc, argv, 1, "aircraft");
+    const char* bombsParameter = optionalParameter(argc, argv, 1, "bombs");
+
+    const unsigned int nClients = clientsParameter ? std::strtoul(clientsParameter, nullptr, 10) : defaultClients;
+    const double seconds = secondsParameter ? std::atof(secondsParameter) : defaultSeconds;
+    const unsigned int nAircraft = aircraftParameter ? std::strtoul(aircraftParameter, nullptr, 10) : defaultAircraft;
+    const unsigned int nBombs = bombsParameter ? std::strtoul(bombsParameter, nullptr, 10) : defaultBombs;
+
+    try {
+        Scene scene(Cartesian3(-33000.0f, 3000.0f, 2000.0f));
+        scene.spawnAircraft(nAircraft);
+        scene.lavaBombBudget.maximumLiveLavaBombs = nBombs;
+        scene.spawnLavaBombs(nBombs);
+
+        MultiplayerServer server(scene);
+        if (!server.open()) {
+            std::cerr << "Unable to open a UDP socket on the loopback interface" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::atomic<bool> stop(false);
+        std::vector<std::unique_ptr<MultiplayerClient>> clients;
+        std::vector<std::thread> clientThreads;
+        for (unsigned int i = 0; i < nClients; i++) {
+            clients.push_back(std::make_unique<MultiplayerClient>());
+            clientThreads.emplace_back(runClient, std::ref(*clients.back()), server.address(), i + 1, std::cref(stop));
+        }
+
+        // Real time, a tick per simulationTimeStep
+        const auto tickPeriod = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(simulationTimeStep));
+        const unsigned long nTicks = static_cast<unsigned long>(seconds / simulationTimeStep);
+        double sendTime = 0.0;
+        unsigned long worldEntities = 0;
+
+        const Clock::time_point start = Clock::now();
+        Clock::time_point nextTick = start;
+        for (unsigned long tick = 0; tick < nTicks; tick++) {
+            server.receive();
+            scene.update(simulationTimeStep);
+
+            const Clock::time_point sendStart = Clock::now();
+            server.sendSnapshots();
+            sendTime += std::chrono::duration<double>(Clock::now() - sendStart).count();
+            worldEntities += scene.aircraft.size() + scene.liveLavaBombs();
+
+            nextTick += tickPeriod;
+            std::this_thread::sleep_until(nextTick);
+        }
+        const double runTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+        stop.store(true);
+        for (std::thread& thread : clientThreads) {
+            thread.join();
+        }
+
+        std::vector<float> latencies;
+        unsigned long snapshotsReceived = 0, bytesReceived = 0, snapshotsDiscarded = 0, nJoined = 0;
+        for (const auto& client : clients) {
+            latencies.insert(latencies.end(), client->statistics.latencies.begin(), client->statistics.latencies.end());
+            snapshotsReceived += client->statistics.snapshotsReceived;
+            bytesReceived += client->statistics.bytesReceived;
+            snapshotsDiscarded += client->statistics.snapshotsDiscarded;
+            nJoined += client->joined;
+        }
+
+        const MultiplayerServerStatistics& sent = server.statistics;
+        const double snapshots = std::max(1.0, static_cast<double>(sent.snapshotsSent));
+        const auto kilobitsPerSecond = [&](const double bytes) { return 8.0 * bytes / 1000.0 / runTime; };
+
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "clients:            " << nJoined << " joined out of " << nClients << std::endl;
+        std::cout << "ticks:              " << nTicks << " over " << runTime << " s" << std::endl;
+        std::cout << "world entities:     " << static_cast<double>(worldEntities) / std::max(1ul, nTicks)
+                  << " per tick" << std::endl;
+        std::cout << "entities sent:      " << sent.entitiesSent / snapshots << " per snapshot, within "
+                  << interestRadius << " m" << std::endl;
+        std::cout << "snapshots sent:     " << sent.snapshotsSent << " (" << sent.fullSnapshotsSent << " in full, "
+                  << sent.sendFailures << " send failures)" << std::endl;
+        std::cout << "snapshots received: " << snapshotsReceived << " (" << snapshotsDiscarded << " discarded)"
+                  << std::endl;
+        std::cout << "bytes per snapshot: " << sent.bytesSent / snapshots << " (raw " << sent.rawBytes / snapshots
+                  << ", " << static_cast<double>(sent.rawBytes) / std::max(1ul, sent.bytesSent) << "x smaller)"
+                  << std::endl;
+        std::cout << "bandwidth:          " << kilobitsPerSecond(sent.bytesSent) << " kbit/s sent, "
+                  << kilobitsPerSecond(bytesReceived) / std::max(1u, nClients) << " kbit/s per client" << std::endl;
+        std::cout << "sendSnapshots:      " << 1000.0 * sendTime / std::max(1ul, nTicks) << " ms per tick"
+                  << std::endl;
+        std::cout << "latency:            p50 " << percentile(latencies, 0.5f) << " ms, p99 "
+                  << percentile(latencies, 0.99f) << " ms, max " << percentile(latencies, 1.0f) << " ms" << std::endl;
+    } catch (const std::string& errorString) {
+        std::cerr << errorString << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
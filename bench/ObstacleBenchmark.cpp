@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "Cartesian3.h"
+#include "ObstacleLayer.h"
+#include "Random.h"
+#include "Terrain.h"
+
+/*
+ * Places obstacles at random over the terrain and compares BVH queries against testing every obstacle.
+ * Run from the repository root so that assets resolve.
+ *
+ * Usage: bin/obstacle-benchmark [obstacles = 100000] [queries = 100000]
+ */
+
+const std::string terrainName = "assets/landscape.dem";
+const std::string towerModelName = "assets/towerModel.tri";
+
+// Queries are spheres the size of a lava bomb, up to this high above the terrain
+constexpr float queryRadius = 100.0f;
+constexpr float maximumQueryAltitude = 300.0f;
+
+// Testing every obstacle is quadratic overall, so it only runs for a subset of the queries
+constexpr int bruteForceQueries = 1000;
+
+typedef std::chrono::steady_clock Clock;
+
+double millisecondsSince(const Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Tests every obstacle, with the same bounds test as the BVH leaves before the exact one
+bool bruteForceSphereCollision(const ObstacleLayer& layer, const std::vector<AxisAlignedBox>& modelBounds,
+                               const Cartesian3& center, const float radius) {
+    for (const auto& obstacle : layer.obstacles) {
+        const AxisAlignedBox& bounds = modelBounds[obstacle.model];
+        if (!AxisAlignedBox(bounds.minimum + obstacle.position, bounds.maximum + obstacle.position)
+            .overlapsSphere(center, radius)) {
+            continue;
+        }
+
+        PlacedConvexHull sphere;
+        sphere.position = center;
+        sphere.margin = radius;
+
+        PlacedConvexHull placedObstacle;
+        placedObstacle.hull = &layer.models[obstacle.model].convexHull;
+        placedObstacle.position = obstacle.position;
+
+        if (isConvexHullCollision(sphere, placedObstacle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    const int nObstacles = argc > 1 ? atoi(argv[1]) : 100000;
+    const int nQueries = argc > 2 ? atoi(argv[2]) : 100000;
+
+    Terrain terrain;
+    if (!terrain.readTerrainFile(terrainName.data(), 500)) {
+        std::cerr << "Unable to read " << terrainName << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ObstacleLayer layer;
+    const int tower = layer.addModel(towerModelName.data());
+    if (tower < 0) {
+        std::cerr << "Unable to read " << towerModelName << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Keep away from the edges, where getHeight is not defined
+    const float halfWidth = 0.45f * terrain.xyScale * terrain.heightValues[0].size();
+    const float halfHeight = 0.45f * terrain.xyScale * terrain.heightValues.size();
+
+    Random random;
+    const auto randomPointOnTerrain = [&](const float altitude) {
+        const float x = random.range(-halfWidth, halfWidth);
+        const float y = random.range(-halfHeight, halfHeight);
+        return Cartesian3(x, y, terrain.getHeight(x, y) + altitude);
+    };
+
+    for (int obstacle = 0; obstacle < nObstacles; obstacle++) {
+        layer.addObstacle(tower, randomPointOnTerrain(0.0f));
+    }
+
+    std::vector<Cartesian3> queries;
+    queries.reserve(nQueries);
+    for (int query = 0; query < nQueries; query++) {
+        queries.push_back(randomPointOnTerrain(random.range(0.0f, maximumQueryAltitude)));
+    }
+
+    const Clock::time_point buildStart = Clock::now();
+    layer.build();
+    const double buildTime = millisecondsSince(buildStart);
+
+    int hierarchyHits = 0;
+    const Clock::time_point hierarchyStart = Clock::now();
+    for (const auto& query : queries) {
+        hierarchyHits += layer.isSphereCollision(query, queryRadius);
+    }
+    const double hierarchyTime = millisecondsSince(hierarchyStart);
+
+    std::vector<AxisAlignedBox> modelBounds(layer.models.size());
+    for (size_t model = 0; model < layer.models.size(); model++) {
+        for (const auto& vertex : layer.models[model].convexHull.vertices) {
+            modelBounds[model].grow(vertex);
+        }
+    }
+
+    const int nBruteForceQueries = std::min(nQueries, bruteForceQueries);
+    int mismatches = 0;
+    const Clock::time_point bruteForceStart = Clock::now();
+    for (int query = 0; query < nBruteForceQueries; query++) {
+        mismatches += bruteForceSphereCollision(layer, modelBounds, queries[query], queryRadius) !=
+                layer.isSphereCollision(queries[query], queryRadius);
+    }
+    // Subtract the BVH queries made for verification
+    const double bruteForceTime = millisecondsSince(bruteForceStart) -
+                                  hierarchyTime * nBruteForceQueries / nQueries;
+
+    std::cout << "obstacles:          " << nObstacles << std::endl;
+    std::cout << "bvh nodes:          " << layer.hierarchy.nodes.size() << std::endl;
+    std::cout << "build:              " << buildTime << " ms" << std::endl;
+    std::cout << "bvh queries:        " << nQueries << ", " << hierarchyHits << " hits" << std::endl;
+    std::cout << "bvh per query:      " << 1000.0 * hierarchyTime / nQueries << " us" << std::endl;
+    std::cout << "linear per query:   " << 1000.0 * bruteForceTime / nBruteForceQueries << " us"
+            << " (over " << nBruteForceQueries << " queries)" << std::endl;
+    std::cout << "mismatches:         " << mismatches << std::endl;
+
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,38 @@
+TEMPLATE = app
+CONFIG += console release c++17 thread
+CONFIG -= qt app_bundle
+# Remove to stop counting heap allocations, which replaces the global operator new & delete
+DEFINES += ENABLE_ALLOCATION_COUNTING
+# Scene links against OpenGL for rendering, which benchmarks never call
+LIBS += -lGL -lGLU
+TARGET = ../bin/micro-benchmarks
+INCLUDEPATH += ../src
+OBJECTS_DIR = ../build/micro-benchmarks/obj
+
+# Input
+SOURCES += MicroBenchmarks.cpp \
+           ../src/AircraftStore.cpp \
+           ../src/AllocationCounter.cpp \
+           ../src/BoundingVolumeHierarchy.cpp \
+           ../src/Cartesian3.cpp \
+           ../src/ConvexCollision.cpp \
+           ../src/ConvexHull.cpp \
+           ../src/FrameArena.cpp \
+           ../src/Homogeneous4.cpp \
+           ../src/HomogeneousFaceSurface.cpp \
+           ../src/IndexedMesh.cpp \
+           ../src/LavaBombParticle.cpp \
+           ../src/Matrix4.cpp \
+           ../src/MemoryReport.cpp \
+           ../src/ObstacleLayer.cpp \
+           ../src/PerformanceCounters.cpp \
+           ../src/PhaseTimer.cpp \
+           ../src/Random.cpp \
+           ../src/Scene.cpp \
+           ../src/SceneAssets.cpp \
+           ../src/SphereCollision.cpp \
+           ../src/TaskGraph.cpp \
+           ../src/Terrain.cpp \
+           ../src/TextScanner.cpp \
+           ../src/TraceEvents.cpp \
+           ../src/WorkStealingPool.cpp
@@ -0,0 +1,48 @@
+TEMPLATE = app
+CONFIG += console release c++17 thread
+CONFIG -= qt app_bundle
+# Scene links against OpenGL for rendering, which the benchmark never calls
+LIBS += -lGL -lGLU
+# shm_open lives in librt on older glibc
+LIBS += -lrt
+TARGET = ../bin/multiplayer-benchmark
+INCLUDEPATH += ../src
+OBJECTS_DIR = ../build/multiplayer-benchmark/obj
+
+# Input
+SOURCES += MultiplayerBenchmark.cpp \
+           ../src/AircraftStore.cpp \
+           ../src/AllocationCounter.cpp \
+           ../src/BoundingVolumeHierarchy.cpp \
+           ../src/Cartesian3.cpp \
+           ../src/CommandLine.cpp \
+           ../src/ControlInput.cpp \
+           ../src/ConvexCollision.cpp \
+           ../src/ConvexHull.cpp \
+           ../src/FrameArena.cpp \
+           ../src/HeldControls.cpp \
+           ../src/Homogeneous4.cpp \
+           ../src/HomogeneousFaceSurface.cpp \
+           ../src/IndexedMesh.cpp \
+           ../src/InputRecording.cpp \
+           ../src/LavaBombParticle.cpp \
+           ../src/Matrix4.cpp \
+           ../src/MemoryReport.cpp \
+           ../src/MultiplayerClient.cpp \
+           ../src/MultiplayerServer.cpp \
+           ../src/ObstacleLayer.cpp \
+           ../src/PerformanceCounters.cpp \
+           ../src/PhaseTimer.cpp \
+           ../src/Random.cpp \
+           ../src/Scene.cpp \
+           ../src/SceneAssets.cpp \
+           ../src/SimulationThread.cpp \
+           ../src/SphereCollision.cpp \
+           ../src/StateSync.cpp \
+           ../src/TaskGraph.cpp \
+           ../src/TelemetryRing.cpp \
+           ../src/Terrain.cpp \
+           ../src/TextScanner.cpp \
+           ../src/TraceEvents.cpp \
+           ../src/UdpSocket.cpp \
+           ../src/WorkStealingPool.cpp
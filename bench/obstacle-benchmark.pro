@@ -0,0 +1,24 @@
+TEMPLATE = app
+CONFIG += console release c++17 thread
+CONFIG -= qt app_bundle
+LIBS += -lGL
+TARGET = ../bin/obstacle-benchmark
+INCLUDEPATH += ../src
+OBJECTS_DIR = ../build/obstacle-benchmark/obj
+
+# Input
+SOURCES += ObstacleBenchmark.cpp \
+           ../src/BoundingVolumeHierarchy.cpp \
+           ../src/Cartesian3.cpp \
+           ../src/ConvexCollision.cpp \
+           ../src/ConvexHull.cpp \
+           ../src/Homogeneous4.cpp \
+           ../src/HomogeneousFaceSurface.cpp \
+           ../src/IndexedMesh.cpp \
+           ../src/Matrix4.cpp \
+           ../src/MemoryReport.cpp \
+           ../src/ObstacleLayer.cpp \
+           ../src/Random.cpp \
+           ../src/Terrain.cpp \
+           ../src/TextScanner.cpp \
+           ../src/TraceEvents.cpp
@@ -0,0 +1,500 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "AllocationCounter.h"
+#include "Cartesian3.h"
+#include "CommandLine.h"
+#include "ControlScript.h"
+#include "IndexedMesh.h"
+#include "InputRecording.h"
+#include "PerformanceCounters.h"
+#include "RewindHistory.h"
+#include "Scene.h"
+#include "SceneState.h"
+#include "SimulationThread.h"
+#include "TelemetryRing.h"
+#include "TraceEvents.h"
+#include "WorkStealingPool.h"
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+/*
+ * Runs a Scene without any window or OpenGL context, as fast as possible, and reports its throughput.
+ * Run from the repository root so that assets resolve.
+ */
+
+constexpr unsigned long defaultTicks = 10000;
+
+typedef std::chrono::steady_clock Clock;
+
+void printUsage() {
+    std::cerr << "Usage: basic-flight-headless <initial (x, y, z)> [options]" << std::endl;
+    std::cerr << "       basic-flight-headless --replay <file> [options]" << std::endl;
+    std::cerr << "       basic-flight-headless --load-state <file> [options]" << std::endl;
+    std::cerr << "  --ticks <n>            ticks to simulate (default: " << defaultTicks << ")" << std::endl;
+    std::cerr << "  --script <file>        control script, one \"<tick> <control>\" line per control" << std::endl;
+    std::cerr << "  --bombs <n>            lava bombs spawned upfront, also the live lava bomb limit" << std::endl;
+    std::cerr << "  --obstacles <file>     .obs file of static obstacles" << std::endl;
+    std::cerr << "  --aircraft <n>         aircraft flying over the terrain besides the player's" << std::endl;
+    std::cerr << "  --seed <n>             random seed (default: drawn at random, and printed)" << std::endl;
+    std::cerr << "  --record <file>        records the run, not combinable with --bombs" << std::endl;
+    std::cerr << "  --replay <file>        replays a recording to its end, checking every tick against it" << std::endl;
+    std::cerr << "  --phase-timings <file> writes per-phase timing statistics as CSV" << std::endl;
+    std::cerr << "  --trace <file>         writes a timeline of every tick as Chrome trace_event JSON" << std::endl;
+    std::cerr << "  --counters on          counts cycles, instructions, cache & branch misses per phase" << std::endl;
+    std::cerr << "  --memory on            reports the scene's memory footprint per buffer" << std::endl;
+    std::cerr << "  --load-state <file>    starts from a state saved by --save-state, not combinable with --record" << std::endl;
+    std::cerr << "  --save-state <file>    saves the state after the last tick" << std::endl;
+    std::cerr << "  --rewind <n>           snapshots every n ticks over the last minute, then checks rewinding" << std::endl;
+    std::cerr << "  --telemetry <name>     publishes every tick to a shared memory ring, see telemetry-reader" << std::endl;
+    std::cerr << "  --update-threads <n>   runs update phases concurrently on n more threads, 0 for one per core"
+            << std::endl;
+    std::cerr << "  --assert-no-allocations <tick>" << std::endl;
+    std::cerr << "                         aborts on any heap allocation by Scene::update from tick on" << std::endl;
+}
+
+// Per tick averages of every counter of every phase, or wall time only where counters are unavailable
+void printPhaseCounters(const PhaseCounters<updatePhaseCount>& phaseCounters) {
+    const PerformanceCounters& counters = phaseCounters.counters;
+
+    if (!counters.anyAvailable()) {
+        std::cout << "hardware counters:  unavailable, wall time only (" << counters.unavailableReason() << ")"
+                << std::endl;
+    } else if (!counters.unavailableReason().empty()) {
+        std::cout << "hardware counters:  partially available, missing ones read as - ("
+                << counters.unavailableReason() << ")" << std::endl;
+    }
+
+    std::cout << "per-phase counters per tick:" << std::endl;
+    std::cout << "  " << std::left << std::setw(26) << "phase" << std::right << std::setw(12) << "wall us";
+    if (counters.anyAvailable()) {
+        for (const char* counterName : hardwareCounterNames) {
+            std::cout << std::setw(15) << counterName;
+        }
+        std::cout << std::setw(8) << "IPC";
+    }
+    if (allocationCountingEnabled) {
+        std::cout << std::setw(10) << "allocs" << std::setw(10) << "bytes";
+    }
+    std::cout << std::endl;
+
+    for (std::size_t phase = 0; phase < updatePhaseCount; phase++) {
+        const CounterValues& totals = phaseCounters.totals[phase];
+        const double samples = std::max<unsigned long>(phaseCounters.samples[phase], 1);
+
+        std::cout << "  " << std::left << std::setw(26) << updatePhaseNames[phase] << std::right
+                << std::setw(12) << totals.wallTime / 1e3 / samples;
+        if (counters.anyAvailable()) {
+            for (std::size_t counter = 0; counter < hardwareCounterCount; counter++) {
+                if (counters.isAvailable(static_cast<HardwareCounter>(counter))) {
+                    std::cout << std::setw(15) << totals.counts[counter] / samples;
+                } else {
+                    std::cout << std::setw(15) << "-";
+                }
+            }
+
+            const auto cycles = totals.counts[static_cast<std::size_t>(HardwareCounter::Cycles)];
+            const auto instructions = totals.counts[static_cast<std::size_t>(HardwareCounter::Instructions)];
+            if (cycles > 0 && counters.isAvailable(HardwareCounter::Instructions)) {
+                std::cout << std::setw(8) << static_cast<double>(instructions) / cycles;
+            } else {
+                std::cout << std::setw(8) << "-";
+            }
+        }
+        if (allocationCountingEnabled) {
+            std::cout << std::setw(10) << totals.allocations / samples
+                    << std::setw(10) << totals.allocatedBytes / samples;
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Welded vertices, and vertices transformed per triangle through a vertexCacheSize entry cache, 3 for a triangle soup
+void printMesh(const char* name, const IndexedMesh& mesh) {
+    std::cout << "  " << std::left << std::setw(18) << name << std::right << mesh.triangleCount() << " triangles, "
+              << mesh.positions.size() << " vertices, " << std::setprecision(2) << mesh.averageCacheMissRatio() << " transforms per triangle"
+              << std::endl;
+}
+
+// Scene buffers, then the process' peak resident set size, which also covers everything the report leaves out
+void printMemoryReport(const Scene& scene) {
+    std::cout << "memory per buffer:" << std::endl;
+    scene.memoryReport().print(std::cout);
+
+    std::cout << "meshes:" << std::endl;
+    printMesh("terrain", scene.terrain.mesh);
+    printMesh("planeModel", scene.planeModel.mesh);
+    printMesh("lavaBombModel", scene.lavaBombModel.mesh);
+
+#ifdef __linux__
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        // ru_maxrss is measured in KiB on Linux
+        std::cout << "peak resident set:  " << usage.ru_maxrss << " KiB" << std::endl;
+    }
+#endif
+}
+
+// Snapshot costs against the time Scene::update took per tick, the fixed tick period timeStep and the run
+// updateTime & runTime are measured in seconds, over nTicks ticks
+// Then rewinds a scene sharing scene's assets to the oldest snapshot and simulates it up to scene's tick with script,
+// returns whether it ends up in the same state
+bool checkRewind(const Scene& scene, RewindHistory& history, ControlScript script, const float timeStep,
+                 const double updateTime, const double runTime, const unsigned long nTicks) {
+    const RewindHistoryStatistics& statistics = history.statistics;
+    if (history.empty()) {
+        std::cout << "rewind:             no snapshot taken" << std::endl;
+        return true;
+    }
+
+    // Snapshots are taken every few ticks, so their cost per tick is spread over the ticks in between
+    const double captureTime = statistics.captureTime / statistics.captures;
+    const double amortizedCaptureTime = statistics.captureTime / nTicks;
+    const double tickUpdateTime = updateTime / nTicks;
+    std::cout << "rewind:             " << statistics.captures << " snapshots, ticks " << history.oldestTick()
+            << " to " << history.newestTick() << " kept in " << history.storedSize() / 1024.0 << " KiB" << std::endl;
+    std::cout << "  per snapshot:     " << 1e6 * captureTime << " us (" << 100.0 * captureTime / tickUpdateTime
+            << "% of a tick's " << 1e6 * tickUpdateTime << " us update, " << 100.0 * captureTime / timeStep
+            << "% of a tick period), " << statistics.stateBytes / statistics.captures << " bytes saved, "
+            << statistics.storedBytes / statistics.captures << " bytes kept" << std::endl;
+    std::cout << "  per tick:         " << 1e6 * amortizedCaptureTime << " us (" << 100.0 * amortizedCaptureTime /
+            tickUpdateTime << "% of a tick's update, " << 100.0 * amortizedCaptureTime / timeStep
+            << "% of a tick period)" << std::endl;
+    std::cout << "  overall:          " << 100.0 * statistics.captureTime / runTime << "% of the run" << std::endl;
+
+    Scene rewound(scene.assets, Cartesian3());
+    const unsigned long rewindTick = history.oldestTick();
+    const Clock::time_point rewindStart = Clock::now();
+    if (!history.rewind(rewindTick, rewound)) {
+        std::cout << "  rewind failed" << std::endl;
+        return false;
+    }
+    const double rewindTime = std::chrono::duration<double>(Clock::now() - rewindStart).count();
+
+    script.seek(rewound.ticks);
+    while (rewound.ticks < scene.ticks) {
+        script.applyDue(rewound);
+        rewound.update(timeStep);
+    }
+
+    const bool matched = rewound.stateHash() == scene.stateHash();
+    std::cout << "  rewound to tick " << rewindTick << " in " << 1e6 * rewindTime << " us, simulating from there "
+            << (matched ? "matched" : "diverged") << std::endl;
+    return matched;
+}
+
+int main(int argc, char** argv) {
+    // Replays take the initial coordinates from the recording, so options may come first
+    const int firstOptional = argc > 1 && isOptionName(argv[1]) ? 1 : 4;
+
+    if (argc < firstOptional || !hasWellFormedOptionalParameters(argc, argv, firstOptional)) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    const char* ticksParameter = optionalParameter(argc, argv, firstOptional, "ticks");
+    const char* scriptParameter = optionalParameter(argc, argv, firstOptional, "script");
+    const char* bombsParameter = optionalParameter(argc, argv, firstOptional, "bombs");
+    const char* seedParameter = optionalParameter(argc, argv, firstOptional, "seed");
+    const char* obstacleFileName = optionalParameter(argc, argv, firstOptional, "obstacles");
+    const char* aircraftParameter = optionalParameter(argc, argv, firstOptional, "aircraft");
+    const char* recordFileName = optionalParameter(argc, argv, firstOptional, "record");
+    const char* replayFileName = optionalParameter(argc, argv, firstOptional, "replay");
+    const char* phaseTimingsFileName = optionalParameter(argc, argv, firstOptional, "phase-timings");
+    const char* traceFileName = optionalParameter(argc, argv, firstOptional, "trace");
+    const char* countersParameter = optionalParameter(argc, argv, firstOptional, "counters");
+    const bool countPhases = countersParameter && std::string(countersParameter) == "on";
+    const char* memoryParameter = optionalParameter(argc, argv, firstOptional, "memory");
+    const bool reportMemory = memoryParameter && std::string(memoryParameter) == "on";
+    const char* loadStateFileName = optionalParameter(argc, argv, firstOptional, "load-state");
+    const char* saveStateFileName = optionalParameter(argc, argv, firstOptional, "save-state");
+    const char* rewindParameter = optionalParameter(argc, argv, firstOptional, "rewind");
+    const char* telemetryName = optionalParameter(argc, argv, firstOptional, "telemetry");
+    const char* updateThreadsParameter = optionalParameter(argc, argv, firstOptional, "update-threads");
+    const char* noAllocationsParameter = optionalParameter(argc, argv, firstOptional, "assert-no-allocations");
+    const unsigned long noAllocationsTick = noAllocationsParameter ? std::strtoul(noAllocationsParameter, nullptr, 10)
+                                                                   : 0;
+
+    // Upfront lava bombs and saved states are not part of recordings, rewinds re-simulate with the script only
+    if ((!replayFileName && !loadStateFileName && firstOptional == 1) ||
+        (recordFileName && (bombsParameter || replayFileName || loadStateFileName)) ||
+        (replayFileName && (loadStateFileName || rewindParameter)) ||
+        (countersParameter && !countPhases) || (memoryParameter && !reportMemory) ||
+        (noAllocationsParameter && !allocationCountingEnabled) || (phaseTimingsFileName && !phaseTimingEnabled) ||
+        // Handing tasks to the pool's queues allocates now and then
+        (noAllocationsParameter && updateThreadsParameter)) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    try {
+        InputReplay replay;
+        RecordingHeader header;
+
+        if (replayFileName) {
+            if (!replay.readRecordingFile(replayFileName)) {
+                std::cerr << "Unable to read recording " << replayFileName << std::endl;
+                return EXIT_FAILURE;
+            }
+            header = replay.header;
+        } else {
+            header.seed = seedParameter ? std::strtoul(seedParameter, nullptr, 10) : std::random_device()();
+            header.timeStep = simulationTimeStep;
+            // Saved states hold the position, and may replace the coordinates
+            if (firstOptional > 1) {
+                header.initialPosition = Cartesian3(atof(argv[1]), atof(argv[2]), atof(argv[3]));
+            }
+            header.obstacleFileName = obstacleFileName ? obstacleFileName : "";
+            header.aircraftCount = aircraftParameter ? std::strtoul(aircraftParameter, nullptr, 10) : 0;
+        }
+
+        const unsigned long nTicks = replayFileName ? replay.lastTick()
+                                                    : ticksParameter ? std::strtoul(ticksParameter, nullptr, 10)
+                                                                     : defaultTicks;
+
+        InputRecorder recorder;
+        if (recordFileName && !recorder.open(recordFileName, header)) {
+            std::cerr << "Unable to write recording " << recordFileName << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (traceFileName) {
+            setTraceThreadName("main");
+            startTracing();
+        }
+
+        const Clock::time_point loadStart = Clock::now();
+
+        Scene scene(header.initialPosition,
+                    header.obstacleFileName.empty() ? nullptr : header.obstacleFileName.c_str(), header.seed);
+        scene.spawnAircraft(header.aircraftCount);
+
+        const double loadTime = std::chrono::duration<double>(Clock::now() - loadStart).count();
+
+        ControlScript script;
+        if (scriptParameter && !script.readControlScriptFile(scriptParameter)) {
+            std::cerr << "Unable to read control script " << scriptParameter << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (loadStateFileName) {
+            std::vector<std::uint8_t> state;
+            if (!readSceneStateFile(loadStateFileName, state) || !scene.restoreState(state)) {
+                std::cerr << "Unable to restore the state saved in " << loadStateFileName << std::endl;
+                return EXIT_FAILURE;
+            }
+            // Script ticks count from the start of the flight the state was saved from
+            script.seek(scene.ticks);
+        }
+
+        if (bombsParameter) {
+            const unsigned int nBombs = std::strtoul(bombsParameter, nullptr, 10);
+            scene.lavaBombBudget.maximumLiveLavaBombs = nBombs;
+            scene.spawnLavaBombs(nBombs);
+        }
+
+        // Opened here, as counters only count the thread that opens them
+        PhaseCounters<updatePhaseCount> phaseCounters;
+        if (countPhases) {
+            phaseCounters.counters.open();
+            scene.updatePhaseCounters = &phaseCounters;
+        }
+
+        // Any thread count evolves the scene identically, replays included
+        std::unique_ptr<WorkStealingPool> updatePool;
+        if (updateThreadsParameter) {
+            updatePool = std::make_unique<WorkStealingPool>(std::strtoul(updateThreadsParameter, nullptr, 10));
+            scene.updatePool = updatePool.get();
+        }
+
+        TelemetryPublisher telemetry;
+        if (telemetryName && !telemetry.open(telemetryName)) {
+            std::cerr << "Unable to create telemetry shared memory " << telemetryName << std::endl;
+            return EXIT_FAILURE;
+        }
+        // Measured in seconds, spent capturing and publishing telemetry records
+        double telemetryTime = 0.0;
+
+        long crashTick = -1;
+        long divergenceTick = -1;
+        unsigned long peakLavaBombs = 0;
+        // Heap allocations by Scene::update, ticks are 1-based
+        AllocationCount updateAllocations;
+        unsigned long allocatingTicks = 0;
+        unsigned long lastAllocatingTick = 0;
+
+        RewindHistory rewindHistory(rewindParameter ? std::strtoul(rewindParameter, nullptr, 10)
+                                                    : defaultRewindInterval);
+        // Measured in seconds, spent in Scene::update, only timed along with rewinding
+        double updateTime = 0.0;
+
+        const unsigned long firstTick = scene.ticks;
+        const Clock::time_point runStart = Clock::now();
+        while (scene.ticks < firstTick + nTicks) {
+            TRACE_SCOPE("simulation", "tick");
+
+            if (replayFileName) {
+                replay.applyDue(scene);
+            } else {
+                script.applyDue(scene, recordFileName ? &recorder : nullptr);
+            }
+
+            const AllocationCount allocationsBefore = threadAllocationCount();
+            // Only timed when snapshot costs are reported against it
+            const Clock::time_point updateStart = rewindParameter ? Clock::now() : Clock::time_point();
+            {
+                const ScopedAllocationBan ban(noAllocationsParameter && scene.ticks + 1 >= noAllocationsTick,
+                                              "Scene::update");
+                scene.update(header.timeStep);
+            }
+            if (rewindParameter) {
+                updateTime += std::chrono::duration<double>(Clock::now() - updateStart).count();
+            }
+            const AllocationCount allocationsAfter = threadAllocationCount();
+            if (allocationsAfter.allocations > allocationsBefore.allocations) {
+                updateAllocations.allocations += allocationsAfter.allocations - allocationsBefore.allocations;
+                updateAllocations.bytes += allocationsAfter.bytes - allocationsBefore.bytes;
+                allocatingTicks++;
+                lastAllocatingTick = scene.ticks;
+            }
+
+            if (telemetry.isOpen()) {
+                const Clock::time_point publishStart = Clock::now();
+                scene.captureTelemetry(telemetry.back());
+                telemetry.publish();
+                telemetryTime += std::chrono::duration<double>(Clock::now() - publishStart).count();
+            }
+
+            if (recordFileName) {
+                recorder.recordStateHash(scene.ticks, scene.stateHash());
+            }
+            if (replayFileName && !replay.verify(scene) && divergenceTick < 0) {
+                divergenceTick = static_cast<long>(scene.ticks);
+            }
+
+            if (rewindParameter) {
+                rewindHistory.capture(scene);
+            }
+
+            peakLavaBombs = std::max<unsigned long>(peakLavaBombs, scene.liveLavaBombs());
+
+            // Keep simulating after a crash, the run measures throughput rather than a flight
+            if (scene.shouldExit && crashTick < 0) {
+                crashTick = static_cast<long>(scene.ticks);
+            }
+        }
+        const double runTime = std::chrono::duration<double>(Clock::now() - runStart).count();
+
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "seed:               " << header.seed << std::endl;
+        std::cout << "load:               " << 1000.0 * loadTime << " ms" << std::endl;
+        scene.assets->printLoadTimes(std::cout);
+        std::cout << "ticks:              " << nTicks << std::endl;
+        std::cout << "run:                " << 1000.0 * runTime << " ms" << std::endl;
+        std::cout << "ticks per second:   " << nTicks / runTime << std::endl;
+        std::cout << "real-time factor:   " << nTicks * simulationTimeStep / runTime << "x" << std::endl;
+        std::cout << "live lava bombs:    " << scene.liveLavaBombs() << " (peak " << peakLavaBombs << ")" << std::endl;
+        if (header.aircraftCount > 0) {
+            std::cout << "aircraft:           " << scene.aircraft.size() << " flying, " << scene.crashedAircraft
+                    << " crashed" << std::endl;
+        }
+        std::cout << "crash tick:         " << (crashTick < 0 ? std::string("none") : std::to_string(crashTick));
+        if (scene.crashCause != CrashCause::None) {
+            std::cout << " (" << crashCauseNames[static_cast<std::size_t>(scene.crashCause)] << ")";
+        }
+        std::cout << std::endl;
+
+        if (updatePool) {
+            if (countPhases) {
+                std::cout << "update threads:     unused, counters only count the thread calling update" << std::endl;
+            } else {
+                std::cout << "update threads:     " << updatePool->threadCount() << " besides the main thread"
+                        << std::endl;
+            }
+        }
+
+        if (allocationCountingEnabled) {
+            std::cout << "update allocations: " << updateAllocations.allocations << " (" << updateAllocations.bytes
+                    << " bytes) over " << allocatingTicks << " ticks, last at tick "
+                    << (allocatingTicks > 0 ? std::to_string(lastAllocatingTick) : std::string("none")) << std::endl;
+        } else {
+            std::cout << "update allocations: not counted, build with ENABLE_ALLOCATION_COUNTING" << std::endl;
+        }
+
+        if (telemetry.isOpen()) {
+            std::cout << "telemetry:          " << nTicks << " records, " << 1e9 * telemetryTime / nTicks
+                    << " ns per record (" << 100.0 * telemetryTime / runTime << "% of the run)" << std::endl;
+        }
+
+        if (saveStateFileName) {
+            std::vector<std::uint8_t> state;
+            scene.saveState(state);
+            if (!writeSceneStateFile(saveStateFileName, state)) {
+                std::cerr << "Unable to save state to " << saveStateFileName << std::endl;
+                return EXIT_FAILURE;
+            }
+            std::cout << "saved state:        tick " << scene.ticks << ", " << state.size() << " bytes" << std::endl;
+        }
+
+        const bool rewindMatched = !rewindParameter ||
+                                   checkRewind(scene, rewindHistory, script, header.timeStep, updateTime, runTime,
+                                               nTicks);
+
+#ifdef ENABLE_PHASE_TIMING
+        std::cout << "per-phase time per tick, in us, overall and over the last " << phaseTimingWindow
+                << " ticks:" << std::endl;
+        std::cout << "  " << std::left << std::setw(26) << "phase" << std::right << std::setw(10) << "overall"
+                << std::setw(10) << "min" << std::setw(10) << "avg" << std::setw(10) << "p99" << std::endl;
+        for (std::size_t phase = 0; phase < updatePhaseCount; phase++) {
+            const PhaseSummary summary = scene.updatePhaseTimings.summarize(phase);
+            std::cout << "  " << std::left << std::setw(26) << updatePhaseNames[phase] << std::right
+                    << std::setw(10) << 1e3 * scene.updatePhaseTimings.total(phase) / nTicks
+                    << std::setw(10) << 1e3 * summary.minimum
+                    << std::setw(10) << 1e3 * summary.average
+                    << std::setw(10) << 1e3 * summary.p99 << std::endl;
+        }
+
+        if (phaseTimingsFileName && !scene.writePhaseTimingsFile(phaseTimingsFileName)) {
+            std::cerr << "Unable to write phase timings to " << phaseTimingsFileName << std::endl;
+        }
+#else
+        std::cout << "per-phase timing:   compiled out, build with ENABLE_PHASE_TIMING" << std::endl;
+#endif
+
+        if (countPhases) {
+            printPhaseCounters(phaseCounters);
+        }
+
+        if (reportMemory) {
+            printMemoryReport(scene);
+        }
+
+        if (traceFileName) {
+            stopTracing();
+            if (!writeTraceFile(traceFileName)) {
+                std::cerr << "Unable to write trace to " << traceFileName << std::endl;
+            }
+        }
+
+        if (replayFileName) {
+            if (divergenceTick >= 0) {
+                std::cout << "replay:             diverged at tick " << divergenceTick << std::endl;
+                return EXIT_FAILURE;
+            }
+            std::cout << "replay:             matched on " << replay.verifiedTicks() << " ticks" << std::endl;
+        }
+
+        return rewindMatched ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (std::string errorString) {
+        std::cout << "Unable to run headless simulation. " << errorString << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,52 @@
+TEMPLATE = app
+CONFIG += console release c++17 thread
+CONFIG -= qt app_bundle
+# Remove to compile out per-phase timing
+DEFINES += ENABLE_PHASE_TIMING
+# Remove to stop counting heap allocations, which replaces the global operator new & delete
+DEFINES += ENABLE_ALLOCATION_COUNTING
+# Debug builds check that update phases running concurrently never access the same data, see TaskGraph.h
+CONFIG(debug, debug|release): DEFINES += ENABLE_TASK_VALIDATION
+# Scene links against OpenGL for rendering, which headless runs never call
+LIBS += -lGL -lGLU
+# shm_open lives in librt on older glibc
+LIBS += -lrt
+TARGET = ../bin/basic-flight-headless
+INCLUDEPATH += ../src
+OBJECTS_DIR = ../build/headless/obj
+
+# Input
+SOURCES += HeadlessRunner.cpp \
+           ../src/AircraftStore.cpp \
+           ../src/AllocationCounter.cpp \
+           ../src/BoundingVolumeHierarchy.cpp \
+           ../src/Cartesian3.cpp \
+           ../src/CommandLine.cpp \
+           ../src/ControlInput.cpp \
+           ../src/ControlScript.cpp \
+           ../src/ConvexCollision.cpp \
+           ../src/ConvexHull.cpp \
+           ../src/FrameArena.cpp \
+           ../src/Homogeneous4.cpp \
+           ../src/HomogeneousFaceSurface.cpp \
+           ../src/IndexedMesh.cpp \
+           ../src/InputRecording.cpp \
+           ../src/LavaBombParticle.cpp \
+           ../src/Matrix4.cpp \
+           ../src/MemoryReport.cpp \
+           ../src/ObstacleLayer.cpp \
+           ../src/PerformanceCounters.cpp \
+           ../src/PhaseTimer.cpp \
+           ../src/Random.cpp \
+           ../src/RewindHistory.cpp \
+           ../src/Scene.cpp \
+           ../src/SceneAssets.cpp \
+           ../src/SceneState.cpp \
+           ../src/SphereCollision.cpp \
+           ../src/StateSync.cpp \
+           ../src/TaskGraph.cpp \
+           ../src/TelemetryRing.cpp \
+           ../src/Terrain.cpp \
+           ../src/TextScanner.cpp \
+           ../src/TraceEvents.cpp \
+           ../src/WorkStealingPool.cpp
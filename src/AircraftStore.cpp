@@ -0,0 +1,262 @@
+#include "AircraftStore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+/*
+ * Movement runs over plain float arrays, without branches, so that compilers vectorize it.
+ * Collision checks only flag aircraft, they are erased in a single compaction pass by removeCrashed.
+ */
+
+constexpr float degreesToRadians = 3.14159265358979f / 180.0f;
+
+AircraftId AircraftStore::add(const Cartesian3& position, const float headingDegrees, const float speed,
+                              const float climbRate, const float turnDegrees) {
+    ids.push_back(nextId);
+    positions.push_back(position);
+    previousPositions.push_back(position);
+    // CCW from +y, i.e. towards -x
+    headingX.push_back(-std::sin(headingDegrees * degreesToRadians));
+    headingY.push_back(std::cos(headingDegrees * degreesToRadians));
+    speeds.push_back(speed);
+    climbRates.push_back(climbRate);
+    turnCos.push_back(std::cos(turnDegrees * degreesToRadians));
+    turnSin.push_back(std::sin(turnDegrees * degreesToRadians));
+    crashed.push_back(0);
+
+    return nextId++;
+}
+
+std::size_t AircraftStore::size() const {
+    return positions.size();
+}
+
+std::size_t AircraftStore::find(const AircraftId id) const {
+    const auto found = std::lower_bound(ids.begin(), ids.end(), id);
+    return found != ids.end() && *found == id ? static_cast<std::size_t>(found - ids.begin()) : size();
+}
+
+void AircraftStore::steer(const std::size_t aircraft, const float speed, const float climbRate,
+                          const float turnDegrees) {
+    speeds[aircraft] = speed;
+    climbRates[aircraft] = climbRate;
+    turnCos[aircraft] = std::cos(turnDegrees * degreesToRadians);
+    turnSin[aircraft] = std::sin(turnDegrees * degreesToRadians);
+}
+
+void AircraftStore::clear() {
+    ids.clear();
+    positions.clear();
+    previousPositions.clear();
+    headingX.clear();
+    headingY.clear();
+    speeds.clear();
+    climbRates.clear();
+    turnCos.clear();
+    turnSin.clear();
+    crashed.clear();
+}
+
+void AircraftStore::move() {
+    const std::size_t n = size();
+
+    previousPositions.x = positions.x;
+    previousPositions.y = positions.y;
+    previousPositions.z = positions.z;
+
+    float* x = positions.x.data();
+    float* y = positions.y.data();
+    float* z = positions.z.data();
+    float* hx = headingX.data();
+    float* hy = headingY.data();
+    const float* speed = speeds.data();
+    const float* climbRate = climbRates.data();
+    const float* c = turnCos.data();
+    const float* s = turnSin.data();
+
+    for (std::size_t i = 0; i < n; i++) {
+        x[i] += speed[i] * hx[i];
+        y[i] += speed[i] * hy[i];
+        z[i] += climbRate[i];
+
+        const float turnedX = c[i] * hx[i] - s[i] * hy[i];
+        const float turnedY = s[i] * hx[i] + c[i] * hy[i];
+        hx[i] = turnedX;
+        hy[i] = turnedY;
+    }
+}
+
+void AircraftStore::checkTerrainCollisions(const Terrain& terrain, const float radius) {
+    const std::size_t n = size();
+
+    for (std::size_t i = 0; i < n; i++) {
+        const float x = positions.x[i];
+        const float y = positions.y[i];
+
+        // There is no terrain to crash against beyond the heightfield
+        if (terrain.contains(x, y) && std::abs(positions.z[i] - terrain.getHeight(x, y)) <= radius) {
+            crashed[i] = 1;
+        }
+    }
+}
+
+void AircraftStore::checkLavaBombCollisions(const PointSpan& lavaBombs, const float radius,
+                                            const float lavaBombRadius) {
+    if (lavaBombs.count == 0) {
+        return;
+    }
+
+    // Lava bombs cluster around the volcano, so most aircraft are rejected by their bounds alone
+    float minimumX = lavaBombs.x[0], minimumY = lavaBombs.y[0], minimumZ = lavaBombs.z[0];
+    float maximumX = minimumX, maximumY = minimumY, maximumZ = minimumZ;
+    for (std::size_t l = 1; l < lavaBombs.count; l++) {
+        minimumX = std::min(minimumX, lavaBombs.x[l]);
+        minimumY = std::min(minimumY, lavaBombs.y[l]);
+        minimumZ = std::min(minimumZ, lavaBombs.z[l]);
+        maximumX = std::max(maximumX, lavaBombs.x[l]);
+        maximumY = std::max(maximumY, lavaBombs.y[l]);
+        maximumZ = std::max(maximumZ, lavaBombs.z[l]);
+    }
+
+    const float reach = radius + lavaBombRadius;
+    const std::size_t n = size();
+
+    for (std::size_t i = 0; i < n; i++) {
+        const float x = positions.x[i];
+        const float y = positions.y[i];
+        const float z = positions.z[i];
+        if (x < minimumX - reach || x > maximumX + reach || y < minimumY - reach || y > maximumY + reach ||
+            z < minimumZ - reach || z > maximumZ + reach) {
+            continue;
+        }
+
+        if (anySphereSphereCollision(position(i), radius, lavaBombs, lavaBombRadius)) {
+            crashed[i] = 1;
+        }
+    }
+}
+
+// Moves the elements of values not flagged in crashed down over the flagged ones, then erases the tail
+template <typename T>
+void eraseFlagged(std::vector<T>& values, const std::vector<std::uint8_t>& crashed) {
+    std::size_t nKept = 0;
+    for (std::size_t i = 0; i < values.size(); i++) {
+        if (!crashed[i]) {
+            values[nKept++] = values[i];
+        }
+    }
+    values.resize(nKept);
+}
+
+std::size_t AircraftStore::removeCrashed() {
+    const std::size_t n = size();
+
+    std::size_t nCrashed = 0;
+    for (const std::uint8_t flag : crashed) {
+        nCrashed += flag;
+    }
+    if (nCrashed == 0) {
+        return 0;
+    }
+
+    eraseFlagged(ids, crashed);
+    eraseFlagged(positions.x, crashed);
+    eraseFlagged(positions.y, crashed);
+    eraseFlagged(positions.z, crashed);
+    eraseFlagged(previousPositions.x, crashed);
+    eraseFlagged(previousPositions.y, crashed);
+    eraseFlagged(previousPositions.z, crashed);
+    eraseFlagged(headingX, crashed);
+    eraseFlagged(headingY, crashed);
+    eraseFlagged(speeds, crashed);
+    eraseFlagged(climbRates, crashed);
+    eraseFlagged(turnCos, crashed);
+    eraseFlagged(turnSin, crashed);
+    crashed.assign(n - nCrashed, 0);
+
+    return nCrashed;
+}
+
+Cartesian3 AircraftStore::position(const std::size_t aircraft) const {
+    return {positions.x[aircraft], positions.y[aircraft], positions.z[aircraft]};
+}
+
+Matrix4 AircraftStore::rotation(const std::size_t aircraft) const {
+    return headingRotation(headingX[aircraft], headingY[aircraft]);
+}
+
+Matrix4 AircraftStore::headingRotation(const float x, const float y) {
+    // Columns are the images of the model axes: +y to the heading, +x to its right, +z unchanged
+    Matrix4 result = Matrix4::identity();
+    result.coordinates[0][0] = y;
+    result.coordinates[0][1] = x;
+    result.coordinates[1][0] = -x;
+    result.coordinates[1][1] = y;
+    return result;
+}
+
+MemoryReport AircraftStore::memoryReport() const {
+    MemoryReport report;
+    report.add("ids", ids);
+    report.add("positions.x", positions.x);
+    report.add("positions.y", positions.y);
+    report.add("positions.z", positions.z);
+    report.add("previousPositions.x", previousPositions.x);
+    report.add("previousPositions.y", previousPositions.y);
+    report.add("previousPositions.z", previousPositions.z);
+    report.add("headingX", headingX);
+    report.add("headingY", headingY);
+    report.add("speeds", speeds);
+    report.add("climbRates", climbRates);
+    report.add("turnCos", turnCos);
+    report.add("turnSin", turnSin);
+    report.add("crashed", crashed);
+    return report;
+}
+
+void AircraftStore::writeState(StateWriter& writer) const {
+    writer.write(nextId);
+    writer.writeArray(ids);
+    writer.writeArray(positions.x);
+    writer.writeArray(positions.y);
+    writer.writeArray(positions.z);
+    writer.writeArray(previousPositions.x);
+    writer.writeArray(previousPositions.y);
+    writer.writeArray(previousPositions.z);
+    writer.writeArray(headingX);
+    writer.writeArray(headingY);
+    writer.writeArray(speeds);
+    writer.writeArray(climbRates);
+    writer.writeArray(turnCos);
+    writer.writeArray(turnSin);
+    writer.writeArray(crashed);
+}
+
+bool AircraftStore::readState(StateReader& reader) {
+    AircraftStore store;
+    if (!reader.read(store.nextId) || !reader.readArray(store.ids) ||
+        !reader.readArray(store.positions.x) || !reader.readArray(store.positions.y) ||
+        !reader.readArray(store.positions.z) || !reader.readArray(store.previousPositions.x) ||
+        !reader.readArray(store.previousPositions.y) || !reader.readArray(store.previousPositions.z) ||
+        !reader.readArray(store.headingX) || !reader.readArray(store.headingY) || !reader.readArray(store.speeds) ||
+        !reader.readArray(store.climbRates) || !reader.readArray(store.turnCos) ||
+        !reader.readArray(store.turnSin) || !reader.readArray(store.crashed)) {
+        return false;
+    }
+
+    const std::size_t n = store.ids.size();
+    for (const std::size_t arraySize : {store.positions.x.size(), store.positions.y.size(),
+                                        store.positions.z.size(), store.previousPositions.x.size(),
+                                        store.previousPositions.y.size(), store.previousPositions.z.size(),
+                                        store.headingX.size(), store.headingY.size(), store.speeds.size(),
+                                        store.climbRates.size(), store.turnCos.size(), store.turnSin.size(),
+                                        store.crashed.size()}) {
+        if (arraySize != n) {
+            return false;
+        }
+    }
+
+    *this = std::move(store);
+    return true;
+}
@@ -0,0 +1,87 @@
+#ifndef AIRCRAFT_STORE
+#define AIRCRAFT_STORE
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Cartesian3.h"
+#include "Matrix4.h"
+#include "MemoryReport.h"
+#include "SceneState.h"
+#include "SphereCollision.h"
+#include "Terrain.h"
+
+// Identifies an aircraft across its lifetime, assigned in order of addition
+typedef std::uint32_t AircraftId;
+
+// Aircraft flying alongside the player's, e.g. AI traffic, as structure-of-arrays
+// Every array holds one element per aircraft, in the same order, so that they are moved and collided in batches
+// Aircraft fly at a constant speed, turning and climbing at constant rates
+class AircraftStore {
+public:
+    // Ascending, since aircraft are appended in order of addition and erasing preserves order
+    std::vector<AircraftId> ids;
+    // Positions as of the latest move, and before it
+    PointBatch positions;
+    PointBatch previousPositions;
+    // Horizontal direction of flight, as a unit vector
+    std::vector<float> headingX;
+    std::vector<float> headingY;
+    // Measured in meters/tick, along the heading and vertically
+    std::vector<float> speeds;
+    std::vector<float> climbRates;
+    // Rotation of the heading per tick, as cos & sin of the turn angle
+    std::vector<float> turnCos;
+    std::vector<float> turnSin;
+    // Nonzero for aircraft flagged by the latest collision checks, until removeCrashed
+    std::vector<std::uint8_t> crashed;
+
+    // Id of the next aircraft added
+    AircraftId nextId = 0;
+
+    // headingDegrees is measured CCW from the +y axis, turnDegrees per tick CCW as well
+    AircraftId add(const Cartesian3& position, float headingDegrees, float speed, float climbRate, float turnDegrees);
+
+    std::size_t size() const;
+
+    // Index of the aircraft identified by id, or size() if it was erased
+    std::size_t find(AircraftId id) const;
+
+    // Changes the speed, climb rate & turn rate of aircraft, measured as in add
+    void steer(std::size_t aircraft, float speed, float climbRate, float turnDegrees);
+
+    // Erases every aircraft, ids are not reused
+    void clear();
+
+    // Moves every aircraft by a tick along its heading, then turns the heading
+    void move();
+
+    // Flags aircraft within radius of the terrain below or above them
+    void checkTerrainCollisions(const Terrain& terrain, float radius);
+
+    // Flags aircraft whose sphere = {position, radius} collides with any sphere = {lavaBombs[i], lavaBombRadius}
+    void checkLavaBombCollisions(const PointSpan& lavaBombs, float radius, float lavaBombRadius);
+
+    // Erases flagged aircraft, keeping the others in order, returns how many were erased
+    std::size_t removeCrashed();
+
+    Cartesian3 position(std::size_t aircraft) const;
+
+    // Rotation of aircraft's model, whose forward is +y, towards its heading
+    Matrix4 rotation(std::size_t aircraft) const;
+
+    // Rotation of a model whose forward is +y towards the unit horizontal heading (x, y)
+    static Matrix4 headingRotation(float x, float y);
+
+    MemoryReport memoryReport() const;
+
+    // Writes every array, see Scene::saveState
+    void writeState(StateWriter& writer) const;
+
+    // Reads arrays written by writeState, replacing every aircraft
+    // returns true on success, false if the state is malformed, leaving the store unchanged
+    bool readState(StateReader& reader);
+};
+
+#endif
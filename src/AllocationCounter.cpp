@@ -0,0 +1,128 @@
+#include "AllocationCounter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Plain data only, so that operator new never triggers thread_local initialization, which may allocate itself
+thread_local AllocationCount allocationCount;
+// Scope of the innermost active ScopedAllocationBan, or null
+thread_local const char* bannedScope = nullptr;
+
+AllocationCount threadAllocationCount() {
+    return allocationCount;
+}
+
+ScopedAllocationBan::ScopedAllocationBan(const bool active, const char* scope)
+    : active(active),
+      previousScope(bannedScope) {
+    if (active) {
+        bannedScope = scope;
+    }
+}
+
+ScopedAllocationBan::~ScopedAllocationBan() {
+    if (active) {
+        bannedScope = previousScope;
+    }
+}
+
+#ifdef ENABLE_ALLOCATION_COUNTING
+void countAllocation(const std::size_t size) {
+    if (bannedScope != nullptr) {
+        // Formatted without allocating, since allocating is what went wrong
+        std::fprintf(stderr, "Heap allocation of %zu bytes within %s, where allocations are banned\n",
+                     size, bannedScope);
+        std::abort();
+    }
+
+    allocationCount.allocations++;
+    allocationCount.bytes += size;
+}
+
+void* allocate(const std::size_t size) {
+    countAllocation(size);
+    // malloc(0) may return null, operator new may not
+    if (void* memory = std::malloc(size > 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* allocateAligned(const std::size_t size, const std::align_val_t alignment) {
+    countAllocation(size);
+    // aligned_alloc requires a size multiple of the alignment
+    const auto alignmentBytes = static_cast<std::size_t>(alignment);
+    const std::size_t alignedSize =
+        (std::max<std::size_t>(size, 1) + alignmentBytes - 1) / alignmentBytes * alignmentBytes;
+    if (void* memory = std::aligned_alloc(alignmentBytes, alignedSize)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](const std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment) {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+#endif
@@ -0,0 +1,42 @@
+#ifndef ALLOCATION_COUNTER
+#define ALLOCATION_COUNTER
+
+#include <cstddef>
+#include <cstdint>
+
+// Built with ENABLE_ALLOCATION_COUNTING defined, the global operator new & delete are replaced by ones
+// counting every allocation per thread. Built without it, counts stay at zero and bans are not enforced
+#ifdef ENABLE_ALLOCATION_COUNTING
+constexpr bool allocationCountingEnabled = true;
+#else
+constexpr bool allocationCountingEnabled = false;
+#endif
+
+struct AllocationCount {
+    std::uint64_t allocations = 0;
+    // Measured in bytes, as requested from operator new
+    std::uint64_t bytes = 0;
+};
+
+// Heap allocations made by the calling thread so far
+AllocationCount threadAllocationCount();
+
+// While alive, and active, any heap allocation by the calling thread aborts the program, naming scope
+// Meant to enforce that steady-state ticks never allocate, e.g. after warming up
+class ScopedAllocationBan {
+public:
+    // scope must outlive the ban, e.g. a string literal
+    ScopedAllocationBan(bool active, const char* scope);
+
+    ~ScopedAllocationBan();
+
+    ScopedAllocationBan(const ScopedAllocationBan&) = delete;
+
+    ScopedAllocationBan& operator =(const ScopedAllocationBan&) = delete;
+
+private:
+    const bool active;
+    const char* previousScope;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include "BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+#include <limits>
+
+// Leaves hold up to this many items, small enough for their exact tests to stay cheap
+constexpr std::uint32_t maximumLeafSize = 4;
+
+AxisAlignedBox::AxisAlignedBox()
+    : minimum(std::numeric_limits<float>::max(),
+              std::numeric_limits<float>::max(),
+              std::numeric_limits<float>::max()),
+      maximum(std::numeric_limits<float>::lowest(),
+              std::numeric_limits<float>::lowest(),
+              std::numeric_limits<float>::lowest()) {
+}
+
+AxisAlignedBox::AxisAlignedBox(const Cartesian3& minimum, const Cartesian3& maximum)
+    : minimum(minimum),
+      maximum(maximum) {
+}
+
+void AxisAlignedBox::grow(const Cartesian3& point) {
+    for (int axis = 0; axis < 3; axis++) {
+        minimum[axis] = std::min(minimum[axis], point[axis]);
+        maximum[axis] = std::max(maximum[axis], point[axis]);
+    }
+}
+
+void AxisAlignedBox::grow(const AxisAlignedBox& other) {
+    grow(other.minimum);
+    grow(other.maximum);
+}
+
+Cartesian3 AxisAlignedBox::centre() const {
+    return (minimum + maximum) * 0.5f;
+}
+
+bool AxisAlignedBox::overlapsSphere(const Cartesian3& center, const float radius) const {
+    // Squared distance from center to the closest point of the box
+    float squaredDistance = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        const float closest = std::clamp(center[axis], minimum[axis], maximum[axis]);
+        const float difference = center[axis] - closest;
+        squaredDistance += difference * difference;
+    }
+    return squaredDistance <= radius * radius;
+}
+
+void BoundingVolumeHierarchy::build(const std::vector<AxisAlignedBox>& itemBounds) {
+    nodes.clear();
+    itemIndices.resize(itemBounds.size());
+    for (std::uint32_t item = 0; item < itemIndices.size(); item++) {
+        itemIndices[item] = item;
+    }
+
+    if (itemBounds.empty()) {
+        return;
+    }
+
+    // A binary tree with leaves of at least 1 item has fewer than 2 * items nodes
+    nodes.reserve(2 * itemBounds.size());
+    buildNode(itemBounds, 0, static_cast<std::uint32_t>(itemBounds.size()));
+}
+
+std::uint32_t BoundingVolumeHierarchy::buildNode(const std::vector<AxisAlignedBox>& itemBounds,
+                                                 const std::uint32_t first,
+                                                 const std::uint32_t count) {
+    const auto nodeIndex = static_cast<std::uint32_t>(nodes.size());
+    nodes.emplace_back();
+
+    AxisAlignedBox bounds;
+    AxisAlignedBox centres;
+    for (std::uint32_t item = first; item < first + count; item++) {
+        bounds.grow(itemBounds[itemIndices[item]]);
+        centres.grow(itemBounds[itemIndices[item]].centre());
+    }
+    nodes[nodeIndex].bounds = bounds;
+
+    if (count <= maximumLeafSize) {
+        nodes[nodeIndex].offset = first;
+        nodes[nodeIndex].itemCount = count;
+        return nodeIndex;
+    }
+
+    // Split at the median centre along the longest axis, which keeps the tree balanced
+    const Cartesian3 extent = centres.maximum - centres.minimum;
+    int axis = 0;
+    if (extent.y > extent[axis]) {
+        axis = 1;
+    }
+    if (extent.z > extent[axis]) {
+        axis = 2;
+    }
+
+    const std::uint32_t half = count / 2;
+    std::nth_element(itemIndices.begin() + first,
+                     itemIndices.begin() + first + half,
+                     itemIndices.begin() + first + count,
+                     [&itemBounds, axis](const std::uint32_t a, const std::uint32_t b) {
+                         return itemBounds[a].centre()[axis] < itemBounds[b].centre()[axis];
+                     });
+
+    // First child follows its parent, the second one's index is only known once the first is built
+    buildNode(itemBounds, first, half);
+    const std::uint32_t secondChild = buildNode(itemBounds, first + half, count - half);
+
+    nodes[nodeIndex].offset = secondChild;
+    nodes[nodeIndex].itemCount = 0;
+
+    return nodeIndex;
+}
@@ -0,0 +1,94 @@
+#ifndef BOUNDING_VOLUME_HIERARCHY
+#define BOUNDING_VOLUME_HIERARCHY
+
+#include <cstdint>
+#include <vector>
+
+#include "Cartesian3.h"
+
+class AxisAlignedBox {
+public:
+    Cartesian3 minimum;
+    Cartesian3 maximum;
+
+    // default to an empty box, which grows to fit whatever is added to it
+    AxisAlignedBox();
+
+    AxisAlignedBox(const Cartesian3& minimum, const Cartesian3& maximum);
+
+    void grow(const Cartesian3& point);
+
+    void grow(const AxisAlignedBox& other);
+
+    Cartesian3 centre() const;
+
+    // whether the sphere = {center, radius} overlaps the box
+    bool overlapsSphere(const Cartesian3& center, float radius) const;
+};
+
+// Binary BVH over a fixed set of boxes, stored as a flat array of nodes in depth-first order
+class BoundingVolumeHierarchy {
+public:
+    struct Node {
+        AxisAlignedBox bounds;
+        // Leaves: index of their first item in itemIndices, inner nodes: index of their second child
+        // The first child of an inner node always follows it
+        std::uint32_t offset;
+        // 0 for inner nodes
+        std::uint32_t itemCount;
+    };
+
+    std::vector<Node> nodes;
+
+    // Item indices, grouped per leaf
+    std::vector<std::uint32_t> itemIndices;
+
+    // Builds the hierarchy by median splits along the longest axis of the item centres
+    void build(const std::vector<AxisAlignedBox>& itemBounds);
+
+    // Calls visitor(itemIndex) for every item whose bounds overlap the sphere = {center, radius}
+    // Traversal stops as soon as visitor returns true, in which case true is returned
+    template <typename Visitor>
+    bool anySphereOverlap(const Cartesian3& center, float radius, Visitor visitor) const;
+
+private:
+    std::uint32_t buildNode(const std::vector<AxisAlignedBox>& itemBounds, std::uint32_t first, std::uint32_t count);
+};
+
+// Median splits keep the hierarchy balanced, so traversal holds at most its depth + 1 nodes
+constexpr int maximumTraversalDepth = 64;
+
+template <typename Visitor>
+bool BoundingVolumeHierarchy::anySphereOverlap(const Cartesian3& center, const float radius, Visitor visitor) const {
+    if (nodes.empty()) {
+        return false;
+    }
+
+    std::uint32_t stack[maximumTraversalDepth];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const std::uint32_t nodeIndex = stack[--stackSize];
+        const Node& node = nodes[nodeIndex];
+
+        if (!node.bounds.overlapsSphere(center, radius)) {
+            continue;
+        }
+
+        if (node.itemCount > 0) {
+            for (std::uint32_t item = node.offset; item < node.offset + node.itemCount; item++) {
+                if (visitor(itemIndices[item])) {
+                    return true;
+                }
+            }
+        } else {
+            stack[stackSize++] = node.offset;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+
+    return false;
+}
+
+#endif
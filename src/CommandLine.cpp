@@ -0,0 +1,29 @@
+#include "CommandLine.h"
+
+#include <cstring>
+
+bool isOptionName(const char* argument) {
+    return argument[0] == '-' && argument[1] == '-' && argument[2] != '\0';
+}
+
+const char* optionalParameter(const int argc, char** argv, const int firstOptional, const char* name) {
+    for (int i = firstOptional; i + 1 < argc; i += 2) {
+        if (isOptionName(argv[i]) && std::strcmp(argv[i] + 2, name) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+bool hasWellFormedOptionalParameters(const int argc, char** argv, const int firstOptional) {
+    if (argc < firstOptional || (argc - firstOptional) % 2 != 0) {
+        return false;
+    }
+
+    for (int i = firstOptional; i < argc; i += 2) {
+        if (!isOptionName(argv[i])) {
+            return false;
+        }
+    }
+    return true;
+}
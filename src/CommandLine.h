@@ -0,0 +1,14 @@
+#ifndef COMMAND_LINE
+#define COMMAND_LINE
+
+// Whether argument is an option name, i.e. --name
+bool isOptionName(const char* argument);
+
+// Optional parameters follow the firstOptional positional ones as --name value pairs
+// Returns the value of --name, or nullptr if absent
+const char* optionalParameter(int argc, char** argv, int firstOptional, const char* name);
+
+// Whether the parameters after the firstOptional positional ones are well-formed --name value pairs
+bool hasWellFormedOptionalParameters(int argc, char** argv, int firstOptional);
+
+#endif
@@ -0,0 +1,49 @@
+#include "ControlInput.h"
+
+#include <array>
+
+constexpr std::array<ControlInput, controlInputCount> controlInputs = {
+    ControlInput::PitchUp,
+    ControlInput::PitchDown,
+    ControlInput::RollLeft,
+    ControlInput::RollRight,
+    ControlInput::YawLeft,
+    ControlInput::YawRight,
+    ControlInput::IncreaseSpeed,
+    ControlInput::DecreaseSpeed,
+    ControlInput::Exit
+};
+
+const char* controlInputName(const ControlInput control) {
+    switch (control) {
+        case ControlInput::PitchUp:
+            return "pitch-up";
+        case ControlInput::PitchDown:
+            return "pitch-down";
+        case ControlInput::RollLeft:
+            return "roll-left";
+        case ControlInput::RollRight:
+            return "roll-right";
+        case ControlInput::YawLeft:
+            return "yaw-left";
+        case ControlInput::YawRight:
+            return "yaw-right";
+        case ControlInput::IncreaseSpeed:
+            return "increase-speed";
+        case ControlInput::DecreaseSpeed:
+            return "decrease-speed";
+        case ControlInput::Exit:
+            return "exit";
+    }
+    return "unknown";
+}
+
+bool parseControlInput(const std::string& name, ControlInput& control) {
+    for (const auto candidate : controlInputs) {
+        if (name == controlInputName(candidate)) {
+            control = candidate;
+            return true;
+        }
+    }
+    return false;
+}
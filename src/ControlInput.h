@@ -0,0 +1,29 @@
+#ifndef CONTROL_INPUT
+#define CONTROL_INPUT
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Discrete commands controlling a Scene, see Scene::applyControl
+enum class ControlInput : std::uint8_t {
+    PitchUp,
+    PitchDown,
+    RollLeft,
+    RollRight,
+    YawLeft,
+    YawRight,
+    IncreaseSpeed,
+    DecreaseSpeed,
+    Exit
+};
+
+constexpr std::size_t controlInputCount = 9;
+
+// kebab-case name of control, e.g. "pitch-up"
+const char* controlInputName(ControlInput control);
+
+// inverse of controlInputName, returns false if name matches no control
+bool parseControlInput(const std::string& name, ControlInput& control);
+
+#endif
@@ -0,0 +1,63 @@
+#include "ControlScript.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+ControlScript::ControlScript()
+    : nextControl(0) {
+}
+
+bool ControlScript::readControlScriptFile(const char* fileName) {
+    std::ifstream inFile(fileName);
+    if (!inFile.good()) {
+        return false;
+    }
+
+    controls.clear();
+    nextControl = 0;
+
+    std::string line;
+    while (std::getline(inFile, line)) {
+        // Drop comments, then skip blank lines
+        line = line.substr(0, line.find('#'));
+        std::istringstream lineStream(line);
+
+        unsigned long tick;
+        if (!(lineStream >> tick)) {
+            continue;
+        }
+
+        std::string controlName;
+        ControlInput control;
+        if (!(lineStream >> controlName) || !parseControlInput(controlName, control)) {
+            return false;
+        }
+
+        controls.push_back({tick, control});
+    }
+
+    std::stable_sort(controls.begin(), controls.end(), [](const ScriptedControl& a, const ScriptedControl& b) {
+        return a.tick < b.tick;
+    });
+
+    return true;
+}
+
+void ControlScript::applyDue(Scene& scene, InputRecorder* recorder) {
+    while (nextControl < controls.size() && controls[nextControl].tick <= scene.ticks) {
+        scene.applyControl(controls[nextControl].control);
+        if (recorder) {
+            recorder->recordControl(scene.ticks, controls[nextControl].control);
+        }
+        nextControl++;
+    }
+}
+
+void ControlScript::seek(const unsigned long tick) {
+    nextControl = std::lower_bound(controls.begin(), controls.end(), tick,
+                                   [](const ScriptedControl& control, const unsigned long value) {
+                                       return control.tick < value;
+                                   }) - controls.begin();
+}
@@ -0,0 +1,39 @@
+#ifndef CONTROL_SCRIPT
+#define CONTROL_SCRIPT
+
+#include <vector>
+
+#include "ControlInput.h"
+#include "InputRecording.h"
+#include "Scene.h"
+
+struct ScriptedControl {
+    // Applied right before the update of this tick, counting from 0
+    unsigned long tick;
+    ControlInput control;
+};
+
+// Sequence of controls to apply at given ticks, in place of live key presses
+class ControlScript {
+public:
+    // Sorted by tick, controls of the same tick keep their order
+    std::vector<ScriptedControl> controls;
+
+    ControlScript();
+
+    // reads a control script, one "<tick> <control name>" line per control, # starts a comment
+    // returns true on success, false otherwise
+    bool readControlScriptFile(const char* fileName);
+
+    // Applies the controls scheduled for scene's next tick, which must not go backwards between calls
+    // Each applied control is also logged to recorder, if any
+    void applyDue(Scene& scene, InputRecorder* recorder = nullptr);
+
+    // Skips to the controls scheduled from tick on, e.g. for a scene restored from a state saved at tick
+    void seek(unsigned long tick);
+
+private:
+    size_t nextControl;
+};
+
+#endif
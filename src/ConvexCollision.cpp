@@ -0,0 +1,183 @@
+#include "ConvexCollision.h"
+
+#include <array>
+#include <initializer_list>
+
+// GJK converges in a handful of iterations for the hulls in the scene, this only guards degenerate cases
+constexpr int maximumGJKIterations = 64;
+// Squared search directions below this mean the origin lies on the simplex
+constexpr float degenerateDirection = 1e-12f;
+
+Cartesian3 PlacedConvexHull::support(const Cartesian3& direction) const {
+    // support(R * H + t, d) = R * support(H, R^T * d) + t
+    Cartesian3 result = position;
+    if (hull != nullptr) {
+        result = result + rotation * hull->support(rotation.transpose() * direction);
+    }
+
+    // Sweeping is the Minkowski sum with the segment [0, sweep]
+    if (sweep.dot(direction) > 0.0f) {
+        result = result + sweep;
+    }
+
+    if (margin > 0.0f) {
+        const float length = direction.length();
+        if (length > 0.0f) {
+            result = result + direction * (margin / length);
+        }
+    }
+
+    return result;
+}
+
+// Support of the Minkowski difference A - B
+Cartesian3 minkowskiSupport(const PlacedConvexHull& a, const PlacedConvexHull& b, const Cartesian3& direction) {
+    return a.support(direction) - b.support(-direction);
+}
+
+// (u x v) x u, perpendicular to u towards v
+Cartesian3 tripleCross(const Cartesian3& u, const Cartesian3& v) {
+    return u.cross(v).cross(u);
+}
+
+/*
+ * Simplex of up to 4 points of the Minkowski difference, newest first.
+ * Each case keeps the feature closest to the origin and points direction towards it,
+ * returning true once the simplex encloses the origin.
+ */
+struct Simplex {
+    std::array<Cartesian3, 4> points;
+    int size = 0;
+
+    void pushFront(const Cartesian3& point) {
+        for (int i = size; i > 0; i--) {
+            points[i] = points[i - 1];
+        }
+        points[0] = point;
+        size++;
+    }
+
+    void set(std::initializer_list<Cartesian3> newPoints) {
+        size = 0;
+        for (const auto& point : newPoints) {
+            points[size++] = point;
+        }
+    }
+
+    bool line(Cartesian3& direction) {
+        const Cartesian3 a = points[0];
+        const Cartesian3 b = points[1];
+        const Cartesian3 ab = b - a;
+        const Cartesian3 ao = -a;
+
+        if (ab.dot(ao) > 0.0f) {
+            direction = tripleCross(ab, ao);
+        } else {
+            set({a});
+            direction = ao;
+        }
+        return false;
+    }
+
+    bool triangle(Cartesian3& direction) {
+        const Cartesian3 a = points[0];
+        const Cartesian3 b = points[1];
+        const Cartesian3 c = points[2];
+        const Cartesian3 ab = b - a;
+        const Cartesian3 ac = c - a;
+        const Cartesian3 ao = -a;
+        const Cartesian3 abc = ab.cross(ac);
+
+        if (abc.cross(ac).dot(ao) > 0.0f) {
+            if (ac.dot(ao) > 0.0f) {
+                set({a, c});
+                direction = tripleCross(ac, ao);
+                return false;
+            }
+            set({a, b});
+            return line(direction);
+        }
+
+        if (ab.cross(abc).dot(ao) > 0.0f) {
+            set({a, b});
+            return line(direction);
+        }
+
+        if (abc.dot(ao) > 0.0f) {
+            direction = abc;
+        } else {
+            set({a, c, b});
+            direction = -abc;
+        }
+        return false;
+    }
+
+    bool tetrahedron(Cartesian3& direction) {
+        const Cartesian3 a = points[0];
+        const Cartesian3 b = points[1];
+        const Cartesian3 c = points[2];
+        const Cartesian3 d = points[3];
+        const Cartesian3 ab = b - a;
+        const Cartesian3 ac = c - a;
+        const Cartesian3 ad = d - a;
+        const Cartesian3 ao = -a;
+
+        // Faces sharing the newest point, the remaining face was already on the origin's side
+        if (ab.cross(ac).dot(ao) > 0.0f) {
+            set({a, b, c});
+            return triangle(direction);
+        }
+        if (ac.cross(ad).dot(ao) > 0.0f) {
+            set({a, c, d});
+            return triangle(direction);
+        }
+        if (ad.cross(ab).dot(ao) > 0.0f) {
+            set({a, d, b});
+            return triangle(direction);
+        }
+        return true;
+    }
+
+    bool next(Cartesian3& direction) {
+        switch (size) {
+            case 2:
+                return line(direction);
+            case 3:
+                return triangle(direction);
+            default:
+                return tetrahedron(direction);
+        }
+    }
+};
+
+bool isConvexHullCollision(const PlacedConvexHull& a, const PlacedConvexHull& b) {
+    Cartesian3 direction = b.position - a.position;
+    if (direction.dot(direction) < degenerateDirection) {
+        direction = Cartesian3(1.0f, 0.0f, 0.0f);
+    }
+
+    Simplex simplex;
+    simplex.pushFront(minkowskiSupport(a, b, direction));
+    direction = -simplex.points[0];
+
+    for (int iteration = 0; iteration < maximumGJKIterations; iteration++) {
+        if (direction.dot(direction) < degenerateDirection) {
+            return true;
+        }
+
+        const Cartesian3 point = minkowskiSupport(a, b, direction);
+
+        // The furthest point towards the origin doesn't pass it, so A - B can't contain it
+        if (point.dot(direction) < 0.0f) {
+            return false;
+        }
+
+        simplex.pushFront(point);
+        if (simplex.next(direction)) {
+            return true;
+        }
+    }
+
+    // Only reached on numerical trouble, err on the side of the broad phase which already passed
+    return true;
+}
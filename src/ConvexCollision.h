@@ -0,0 +1,26 @@
+#ifndef CONVEX_COLLISION
+#define CONVEX_COLLISION
+
+#include "Cartesian3.h"
+#include "ConvexHull.h"
+#include "Matrix4.h"
+
+// Convex shape in world coordinates as seen by GJK, through its support mapping:
+// hull rotated by rotation and translated by position, swept along sweep and inflated by margin
+struct PlacedConvexHull {
+    // nullptr stands for a single point at the origin, e.g. a sphere when combined with margin
+    const ConvexHull* hull = nullptr;
+    // Must be a pure rotation
+    Matrix4 rotation = Matrix4::identity();
+    Cartesian3 position;
+    // Shape covers every placement from position to position + sweep
+    Cartesian3 sweep;
+    float margin = 0.0f;
+
+    Cartesian3 support(const Cartesian3& direction) const;
+};
+
+// GJK intersection test, meant as narrow phase once a bounding sphere test has passed
+bool isConvexHullCollision(const PlacedConvexHull& a, const PlacedConvexHull& b);
+
+#endif
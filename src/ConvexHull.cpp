@@ -0,0 +1,50 @@
+#include "ConvexHull.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+ConvexHull::ConvexHull() {
+    vertices.clear();
+}
+
+void ConvexHull::compute(const std::vector<Homogeneous4>& points) {
+    vertices.clear();
+    vertices.reserve(points.size());
+    for (const auto& point : points) {
+        vertices.emplace_back(point.Point());
+    }
+
+    // Sort lexicographically so that coincident vertices end up next to each other
+    const auto lexicographic = [](const Cartesian3& a, const Cartesian3& b) {
+        return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+    };
+    const auto coincident = [](const Cartesian3& a, const Cartesian3& b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    };
+    std::sort(vertices.begin(), vertices.end(), lexicographic);
+    vertices.erase(std::unique(vertices.begin(), vertices.end(), coincident), vertices.end());
+    vertices.shrink_to_fit();
+}
+
+Cartesian3 ConvexHull::support(const Cartesian3& direction) const {
+    Cartesian3 furthest;
+    float furthestDistance = -std::numeric_limits<float>::infinity();
+
+    for (const auto& vertex : vertices) {
+        if (const float distance = vertex.dot(direction); distance > furthestDistance) {
+            furthest = vertex;
+            furthestDistance = distance;
+        }
+    }
+
+    return furthest;
+}
+
+float ConvexHull::boundingRadius() const {
+    float radius = 0.0f;
+    for (const auto& vertex : vertices) {
+        radius = std::max(radius, vertex.length());
+    }
+    return radius;
+}
@@ -0,0 +1,27 @@
+#ifndef CONVEX_HULL
+#define CONVEX_HULL
+
+#include <vector>
+
+#include "Cartesian3.h"
+#include "Homogeneous4.h"
+
+// Convex hull of a point cloud, represented by its distinct points
+// Interior points are kept, which doesn't change the support mapping, the only query GJK relies on
+class ConvexHull {
+public:
+    std::vector<Cartesian3> vertices;
+
+    ConvexHull();
+
+    // Welds exactly coincident vertices
+    void compute(const std::vector<Homogeneous4>& points);
+
+    // Furthest vertex in direction, any of them if several are equally far
+    Cartesian3 support(const Cartesian3& direction) const;
+
+    // Distance from the origin to the furthest vertex
+    float boundingRadius() const;
+};
+
+#endif
@@ -1,5 +1,13 @@
 #include "FlightSimulatorWidget.h"
 
+#include <QCoreApplication>
+#include <QFont>
+#include <QPainter>
+#include <QString>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
 #ifdef __APPLE__
 #include <OpenGL/gl.h>
 #include <OpenGL/glu.h>
@@ -8,14 +16,26 @@
 #include <GL/glu.h>
 #endif
 
+#include "TraceEvents.h"
+
 constexpr float millisInFrame = 16.7f;
-constexpr float millisInSecond = 1000.0f;
-constexpr float timeStep = millisInFrame / millisInSecond;
+constexpr float nanosInMilli = 1000000.0f;
+// Frames between refreshes of the frame pacing shown in the window title
+constexpr unsigned int framesPerTitleUpdate = 60;
 
-FlightSimulatorWidget::FlightSimulatorWidget(QWidget* parent, Scene* scene)
+FlightSimulatorWidget::FlightSimulatorWidget(QWidget* parent,
+                                             Scene* scene,
+                                             SimulationThread* simulation,
+                                             const float frameBudget)
     : _FLIGHT_SIMULATOR_PARENT_CLASS(parent),
-      scene(scene) {
+      scene(scene),
+      simulation(simulation),
+      governor(frameBudget),
+      framesSinceTitleUpdate(0),
+      renderedPresses(0),
+      showPhaseOverlay(false) {
     animationTimer = new QTimer(this);
+    animationTimer->setTimerType(Qt::PreciseTimer);
     connect(animationTimer, SIGNAL(timeout()), this, SLOT(nextFrame()));
     animationTimer->start(millisInFrame);
 }
@@ -44,52 +64,179 @@ void FlightSimulatorWidget::resizeGL(const int width, const int height) {
 }
 
 void FlightSimulatorWidget::paintGL() {
-    scene->render();
+    TRACE_SCOPE("render", "frame");
+
+    if (frameTimer.isValid()) {
+        framePacing.recordInterval(frameTimer.nsecsElapsed() / nanosInMilli);
+    }
+    frameTimer.start();
+
+    if (++framesSinceTitleUpdate >= framesPerTitleUpdate) {
+        framesSinceTitleUpdate = 0;
+        QString title = QString("basic-flight - %1 fps, frame jitter %2 ms, longest frame %3 ms")
+            .arg(framePacing.framesPerSecond(), 0, 'f', 1)
+            .arg(framePacing.jitter(), 0, 'f', 2)
+            .arg(framePacing.longestInterval(), 0, 'f', 1);
+        if (inputLatency.recorded(0) > 0) {
+            const PhaseSummary latency = inputLatency.summarize(0);
+            title += QString(", input latency %1 ms (p99 %2 ms)")
+                .arg(latency.average, 0, 'f', 1)
+                .arg(latency.p99, 0, 'f', 1);
+        }
+        setWindowTitle(title);
+        framePacing.resetLongestInterval();
+
+        if (showPhaseOverlay) {
+            refreshPhaseOverlay();
+        }
+    }
+
+    QElapsedTimer renderTimer;
+    renderTimer.start();
+
+    // Simulation runs a tick behind real time, so that frames fall between its two latest ticks
+    const SceneSnapshot& snapshot = simulation->latestSnapshot();
+    const float sinceTick = std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot.tickTime).count();
+    const float alpha = snapshot.timeStep > 0.0f ? std::clamp(sinceTick / snapshot.timeStep, 0.0f, 1.0f) : 1.0f;
+
+    scene->render(snapshot, alpha);
+
+    governor.recordRenderCost(renderTimer.nsecsElapsed() / nanosInMilli);
+
+    if (showPhaseOverlay) {
+        renderPhaseOverlay();
+    }
+
+    // Only the latest press is measured when a snapshot applied several since the previous frame
+    if (snapshot.appliedPresses != renderedPresses) {
+        renderedPresses = snapshot.appliedPresses;
+        inputLatency.record(0, std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - snapshot.latestPressTime).count());
+    }
 }
 
-void FlightSimulatorWidget::keyPressEvent(QKeyEvent* event) {
-    switch (event->key()) {
-        case Qt::Key_X:
-            scene->shouldExit = true;
-            break;
+void FlightSimulatorWidget::refreshPhaseOverlay() {
+#ifndef ENABLE_PHASE_TIMING
+    phaseOverlayText = "Phase timing compiled out, build with ENABLE_PHASE_TIMING";
+#else
+
+    const auto line = [](const char* group, const char* phase, const PhaseSummary& summary) {
+        return QString("%1 %2 %3 %4 %5\n")
+            .arg(QString(group), -7)
+            .arg(QString(phase), -24)
+            .arg(summary.minimum, 7, 'f', 3)
+            .arg(summary.average, 7, 'f', 3)
+            .arg(summary.p99, 7, 'f', 3);
+    };
+
+    phaseOverlayText = QString("%1 %2 %3 %4 %5\n").arg(QString(), -7).arg(QString("phase (ms)"), -24)
+        .arg(QString("min"), 7).arg(QString("avg"), 7).arg(QString("p99"), 7);
+
+    const UpdatePhaseSummaries& updateSummaries = simulation->latestUpdatePhaseSummaries();
+    for (std::size_t phase = 0; phase < updatePhaseCount; phase++) {
+        phaseOverlayText += line("update", updatePhaseNames[phase], updateSummaries[phase]);
+    }
+    for (std::size_t phase = 0; phase < renderPhaseCount; phase++) {
+        phaseOverlayText += line("render", renderPhaseNames[phase], scene->renderPhaseTimings.summarize(phase));
+    }
+#endif
+}
+
+void FlightSimulatorWidget::renderPhaseOverlay() {
+    // Drawn on top of the OpenGL frame, QPainter restores the state it changes
+    QPainter painter(this);
+    painter.setFont(QFont("Monospace", 9));
+    painter.setPen(Qt::black);
+    painter.drawText(rect().adjusted(10, 10, -10, -10), Qt::AlignLeft | Qt::AlignTop, phaseOverlayText);
+}
+
+bool FlightSimulatorWidget::heldControl(const int key, ControlInput& control) {
+    switch (key) {
         case Qt::Key_A:
-            scene->pitchDown();
-            break;
+            control = ControlInput::PitchDown;
+            return true;
         case Qt::Key_S:
-            scene->pitchUp();
-            break;
+            control = ControlInput::PitchUp;
+            return true;
         case Qt::Key_Q:
-            scene->rollLeft();
-            break;
+            control = ControlInput::RollLeft;
+            return true;
         case Qt::Key_E:
-            scene->rollRight();
-            break;
+            control = ControlInput::RollRight;
+            return true;
         case Qt::Key_W:
-            scene->yawLeft();
-            break;
+            control = ControlInput::YawLeft;
+            return true;
         case Qt::Key_D:
-            scene->yawRight();
-            break;
+            control = ControlInput::YawRight;
+            return true;
         case Qt::Key_Plus:
-            scene->increaseSpeed();
-            break;
+            control = ControlInput::IncreaseSpeed;
+            return true;
         case Qt::Key_Minus:
-            scene->decreaseSpeed();
-            break;
+            control = ControlInput::DecreaseSpeed;
+            return true;
+        case Qt::Key_X:
+            control = ControlInput::Exit;
+            return true;
         default:
-            break;
+            return false;
+    }
+}
+
+void FlightSimulatorWidget::keyPressEvent(QKeyEvent* event) {
+    // Held keys are applied once per tick by the simulation, OS repeats would only add noise
+    if (event->isAutoRepeat()) {
+        return;
     }
 
-    // always update to force the animation to continue
-    _FLIGHT_SIMULATOR_UPDATE_CALL();
+    ControlInput control;
+    if (heldControl(event->key(), control)) {
+        simulation->pressControl(control);
+    } else if (event->key() == Qt::Key_T) {
+        showPhaseOverlay = !showPhaseOverlay;
+        if (showPhaseOverlay) {
+            refreshPhaseOverlay();
+        }
+    } else {
+        _FLIGHT_SIMULATOR_PARENT_CLASS::keyPressEvent(event);
+    }
+
+    // Frames are paced by animationTimer, and show the effect of the key once a tick has applied it
+}
+
+void FlightSimulatorWidget::keyReleaseEvent(QKeyEvent* event) {
+    if (event->isAutoRepeat()) {
+        return;
+    }
+
+    ControlInput control;
+    if (heldControl(event->key(), control)) {
+        simulation->releaseControl(control);
+    } else {
+        _FLIGHT_SIMULATOR_PARENT_CLASS::keyReleaseEvent(event);
+    }
+}
+
+void FlightSimulatorWidget::focusOutEvent(QFocusEvent* event) {
+    simulation->releaseAllControls();
+    _FLIGHT_SIMULATOR_PARENT_CLASS::focusOutEvent(event);
 }
 
 void FlightSimulatorWidget::nextFrame() {
-    if (scene->shouldExit) {
-        exit(0);
+    // Simulation runs on its own thread, frames only render its latest snapshot
+    if (simulation->latestSnapshot().shouldExit) {
+        QCoreApplication::quit();
+        return;
     }
 
-    scene->update(timeStep);
+    governor.recordUpdateCost(simulation->latestUpdateCost());
+
+    // Report every decision, since they change how the volcano behaves
+    if (governor.adjust()) {
+        simulation->pushLavaBombBudget(governor.budget());
+        std::cout << "Frame budget governor: " << governor << std::endl;
+    }
 
     update();
 }
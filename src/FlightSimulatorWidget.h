@@ -2,8 +2,12 @@
 #define FLIGHT_SIMULATOR_WIDGET
 
 #include <QtGlobal>
+#include <QElapsedTimer>
 #include <QTimer>
+#include <QFocusEvent>
+#include <QKeyEvent>
 #include <QMouseEvent>
+#include <QString>
 
 // this is necessary to allow compilation in both Qt 5 and Qt 6
 #if (QT_VERSION < 0x060000)
@@ -16,17 +20,35 @@
 #define _GL_WIDGET_UPDATE_CALL update
 #endif
 
+#include "FrameBudgetGovernor.h"
+#include "FramePacing.h"
 #include "Scene.h"
+#include "SimulationThread.h"
 
 class FlightSimulatorWidget : public _FLIGHT_SIMULATOR_PARENT_CLASS {
     Q_OBJECT
 
 public:
+    // Only its static parts are used directly, its dynamic state is owned by simulation
     Scene* scene;
 
+    SimulationThread* simulation;
+
     QTimer* animationTimer;
 
-    FlightSimulatorWidget(QWidget* parent, Scene* scene);
+    // Adapts the lava bomb load of scene to the measured cost of each frame
+    FrameBudgetGovernor governor;
+
+    // Measured intervals between rendered frames, also shown in the window title
+    FramePacing framePacing;
+
+    // Measured in milliseconds, from receiving a key press to the end of the first frame rendering its effect,
+    // i.e. handing that frame to OpenGL, which swaps buffers and scans out afterwards. Also shown in the window title
+    DurationSamples<1> inputLatency;
+
+    // frameBudget is measured in milliseconds
+    FlightSimulatorWidget(QWidget* parent, Scene* scene, SimulationThread* simulation,
+                          float frameBudget = defaultFrameBudget);
 
 protected:
     void initializeGL() override;
@@ -37,8 +59,33 @@ protected:
 
     void keyPressEvent(QKeyEvent* event) override;
 
+    void keyReleaseEvent(QKeyEvent* event) override;
+
+    // Releases every control, as the keys' releases go to whichever window has focus
+    void focusOutEvent(QFocusEvent* event) override;
+
 public slots:
     void nextFrame();
+
+private:
+    // Monotonic, restarted on every rendered frame
+    QElapsedTimer frameTimer;
+    unsigned int framesSinceTitleUpdate;
+
+    // Key presses applied by the latest snapshot rendered
+    unsigned long renderedPresses;
+
+    // Toggled with T, per-phase timing statistics drawn over the scene
+    bool showPhaseOverlay;
+    QString phaseOverlayText;
+
+    // Rebuilds phaseOverlayText from the latest statistics of both update & render phases
+    void refreshPhaseOverlay();
+
+    void renderPhaseOverlay();
+
+    // Control held down by key, returns false if key controls nothing
+    static bool heldControl(int key, ControlInput& control);
 };
 
 #endif
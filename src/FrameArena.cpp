@@ -0,0 +1,59 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+
+std::size_t maxAlignUnits(const std::size_t bytes) {
+    return (bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+}
+
+FrameArena::FrameArena(const std::size_t initialCapacity)
+    : block(new std::max_align_t[maxAlignUnits(initialCapacity)]),
+      blockSize(maxAlignUnits(initialCapacity) * sizeof(std::max_align_t)),
+      offset(0),
+      spilledBytes(0),
+      peak(0),
+      reservedCapacity(0) {
+}
+
+void* FrameArena::allocateBytes(const std::size_t bytes, const std::size_t alignment) {
+    const std::size_t start = (offset + alignment - 1) / alignment * alignment;
+    if (start + bytes <= blockSize) {
+        offset = start + bytes;
+        return reinterpret_cast<unsigned char*>(block.get()) + start;
+    }
+
+    spills.emplace_back(new std::max_align_t[maxAlignUnits(bytes)]);
+    spilledBytes += bytes;
+    return spills.back().get();
+}
+
+void FrameArena::reset() {
+    peak = std::max(peak, used());
+
+    if (!spills.empty() || blockSize < reservedCapacity) {
+        // Twice what the tick needed, so that slowly growing loads don't regrow the block every tick
+        const std::size_t units = maxAlignUnits(std::max(spills.empty() ? 0 : 2 * used(), reservedCapacity));
+        block.reset(new std::max_align_t[units]);
+        blockSize = units * sizeof(std::max_align_t);
+        spills.clear();
+        spilledBytes = 0;
+    }
+
+    offset = 0;
+}
+
+void FrameArena::reserve(const std::size_t capacity) {
+    reservedCapacity = std::max(reservedCapacity, capacity);
+}
+
+std::size_t FrameArena::used() const {
+    return offset + spilledBytes;
+}
+
+std::size_t FrameArena::capacity() const {
+    return blockSize;
+}
+
+std::size_t FrameArena::highWater() const {
+    return std::max(peak, used());
+}
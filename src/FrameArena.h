@@ -0,0 +1,61 @@
+#ifndef FRAME_ARENA
+#define FRAME_ARENA
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for data living no longer than a single tick, e.g. collision points or spawn lists
+// Everything allocated is released at once by reset, nothing is ever destroyed individually
+// Allocations beyond the block spill onto the heap, the next reset grows the block to fit them instead,
+// so that ticks stop allocating once the arena has seen the largest one
+class FrameArena {
+public:
+    // Measured in bytes
+    explicit FrameArena(std::size_t initialCapacity = 16 * 1024);
+
+    // Storage for count default-constructed Ts, valid until the next reset
+    template <typename T>
+    T* allocate(const std::size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Arena blocks are only aligned to max_align_t");
+
+        T* objects = static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T)));
+        for (std::size_t i = 0; i < count; i++) {
+            new (objects + i) T();
+        }
+        return objects;
+    }
+
+    // Releases everything allocated since the previous reset
+    void reset();
+
+    // Measured in bytes, grows the block to at least capacity on the next reset, so that ticks known to need
+    // that much never spill
+    void reserve(std::size_t capacity);
+
+    // Measured in bytes, allocated since the previous reset, spilled allocations included
+    std::size_t used() const;
+
+    // Measured in bytes, size of the block
+    std::size_t capacity() const;
+
+    // Measured in bytes, the most used between any two resets
+    std::size_t highWater() const;
+
+private:
+    std::unique_ptr<std::max_align_t[]> block;
+    std::size_t blockSize;
+    std::size_t offset;
+    // Allocations which didn't fit in block, freed on reset
+    std::vector<std::unique_ptr<std::max_align_t[]>> spills;
+    std::size_t spilledBytes;
+    std::size_t peak;
+    std::size_t reservedCapacity;
+
+    void* allocateBytes(std::size_t bytes, std::size_t alignment);
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "FrameBudgetGovernor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+// Weight of the latest sample in the exponential moving averages of costs
+constexpr float costSmoothing = 0.1f;
+// Frames between load adjustments, gives the averages time to settle on the new load
+constexpr unsigned int framesPerAdjustment = 30;
+
+// Fractions of the frame budget above which load is cut, and below which it is grown
+constexpr float overBudgetRatio = 0.9f;
+constexpr float underBudgetRatio = 0.6f;
+constexpr float loadDecreaseFactor = 0.8f;
+constexpr float loadIncreaseStep = 0.05f;
+
+constexpr float minimumLoad = 0.05f;
+constexpr float maximumLoad = 4.0f;
+
+constexpr unsigned int maximumExplosionFanOut = 12;
+
+FrameBudgetGovernor::FrameBudgetGovernor(const float frameBudget)
+    : targetFrameCost(frameBudget),
+      averageUpdateCost(0.0f),
+      averageRenderCost(0.0f),
+      load(1.0f),
+      framesSinceAdjustment(0) {
+}
+
+void FrameBudgetGovernor::recordUpdateCost(const float milliseconds) {
+    averageUpdateCost += costSmoothing * (milliseconds - averageUpdateCost);
+}
+
+void FrameBudgetGovernor::recordRenderCost(const float milliseconds) {
+    averageRenderCost += costSmoothing * (milliseconds - averageRenderCost);
+}
+
+bool FrameBudgetGovernor::adjust() {
+    if (++framesSinceAdjustment < framesPerAdjustment) {
+        return false;
+    }
+    framesSinceAdjustment = 0;
+
+    const float previousLoad = load;
+    const float frameCost = averageFrameCost();
+
+    if (frameCost > overBudgetRatio * targetFrameCost) {
+        load = std::max(minimumLoad, load * loadDecreaseFactor);
+    } else if (frameCost < underBudgetRatio * targetFrameCost) {
+        load = std::min(maximumLoad, load + loadIncreaseStep);
+    }
+
+    return load != previousLoad;
+}
+
+LavaBombBudget FrameBudgetGovernor::budget() const {
+    const LavaBombBudget defaults;
+    LavaBombBudget scaled;
+
+    scaled.spawnInterval = defaults.spawnInterval / load;
+    scaled.explosionFanOut = std::clamp(
+        static_cast<unsigned int>(std::lround(defaults.explosionFanOut * load)), 1u, maximumExplosionFanOut);
+    scaled.maximumLiveLavaBombs = std::max(
+        1u, static_cast<unsigned int>(std::lround(defaults.maximumLiveLavaBombs * load)));
+
+    return scaled;
+}
+
+float FrameBudgetGovernor::frameBudget() const {
+    return targetFrameCost;
+}
+
+float FrameBudgetGovernor::averageFrameCost() const {
+    return averageUpdateCost + averageRenderCost;
+}
+
+float FrameBudgetGovernor::loadFactor() const {
+    return load;
+}
+
+std::ostream& operator <<(std::ostream& outStream, const FrameBudgetGovernor& governor) {
+    const LavaBombBudget budget = governor.budget();
+    return outStream << std::fixed << std::setprecision(2)
+           << "frame " << governor.averageFrameCost() << "/" << governor.frameBudget() << " ms"
+           << ", load " << governor.loadFactor()
+           << ", spawn interval " << budget.spawnInterval << " s"
+           << ", explosion fan-out " << budget.explosionFanOut
+           << ", max live lava bombs " << budget.maximumLiveLavaBombs;
+}
@@ -0,0 +1,47 @@
+#ifndef FRAME_BUDGET_GOVERNOR
+#define FRAME_BUDGET_GOVERNOR
+
+#include <iostream>
+
+#include "Scene.h"
+
+// Measured in milliseconds, one frame at 60 Hz
+constexpr float defaultFrameBudget = 1000.0f / 60.0f;
+
+// Scales the lava bomb load of a Scene so that the cost of a frame stays within a budget
+// Load is cut multiplicatively when over budget and grown additively when well under it
+class FrameBudgetGovernor {
+public:
+    // frameBudget is measured in milliseconds
+    explicit FrameBudgetGovernor(float frameBudget = defaultFrameBudget);
+
+    // Measured cost, in milliseconds, of the latest Scene::update and Scene::render respectively
+    void recordUpdateCost(float milliseconds);
+
+    void recordRenderCost(float milliseconds);
+
+    // Called once per frame, re-evaluates the load every 30 frames, returns whether the budget changed
+    bool adjust();
+
+    // Budget matching the current load, relative to the default LavaBombBudget
+    LavaBombBudget budget() const;
+
+    float frameBudget() const;
+
+    // Smoothed update + render cost, in milliseconds
+    float averageFrameCost() const;
+
+    // 1 reproduces the default LavaBombBudget
+    float loadFactor() const;
+
+private:
+    float targetFrameCost;
+    float averageUpdateCost;
+    float averageRenderCost;
+    float load;
+    unsigned int framesSinceAdjustment;
+};
+
+std::ostream& operator <<(std::ostream& outStream, const FrameBudgetGovernor& governor);
+
+#endif
@@ -0,0 +1,56 @@
+#include "FramePacing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+// Weight of the latest interval in the exponential moving averages
+constexpr float intervalSmoothing = 0.05f;
+
+FramePacing::FramePacing()
+    : smoothedInterval(0.0f),
+      smoothedDeviation(0.0f),
+      longest(0.0f),
+      empty(true) {
+}
+
+void FramePacing::recordInterval(const float interval) {
+    longest = std::max(longest, interval);
+
+    if (empty) {
+        smoothedInterval = interval;
+        empty = false;
+        return;
+    }
+
+    smoothedDeviation += intervalSmoothing * (std::abs(interval - smoothedInterval) - smoothedDeviation);
+    smoothedInterval += intervalSmoothing * (interval - smoothedInterval);
+}
+
+float FramePacing::averageInterval() const {
+    return smoothedInterval;
+}
+
+float FramePacing::jitter() const {
+    return smoothedDeviation;
+}
+
+float FramePacing::longestInterval() const {
+    return longest;
+}
+
+float FramePacing::framesPerSecond() const {
+    return smoothedInterval > 0.0f ? 1000.0f / smoothedInterval : 0.0f;
+}
+
+void FramePacing::resetLongestInterval() {
+    longest = 0.0f;
+}
+
+std::ostream& operator <<(std::ostream& outStream, const FramePacing& pacing) {
+    return outStream << std::fixed << std::setprecision(1)
+           << pacing.framesPerSecond() << " fps"
+           << ", interval " << pacing.averageInterval() << " ms"
+           << ", jitter " << pacing.jitter() << " ms"
+           << ", longest " << pacing.longestInterval() << " ms";
+}
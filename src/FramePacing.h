@@ -0,0 +1,36 @@
+#ifndef FRAME_PACING
+#define FRAME_PACING
+
+#include <iostream>
+
+// Smoothed statistics over the intervals between consecutive frames
+class FramePacing {
+public:
+    FramePacing();
+
+    // interval is measured in milliseconds
+    void recordInterval(float interval);
+
+    // Measured in milliseconds
+    float averageInterval() const;
+
+    // Mean absolute deviation of intervals from averageInterval, in milliseconds
+    float jitter() const;
+
+    // Longest interval since the last reset, in milliseconds
+    float longestInterval() const;
+
+    float framesPerSecond() const;
+
+    void resetLongestInterval();
+
+private:
+    float smoothedInterval;
+    float smoothedDeviation;
+    float longest;
+    bool empty;
+};
+
+std::ostream& operator <<(std::ostream& outStream, const FramePacing& pacing);
+
+#endif
@@ -0,0 +1,66 @@
+#include "HeldControls.h"
+
+// Ticks between repeats of control while held, 0 if it never repeats
+unsigned int repeatTicks(const ControlInput control) {
+    switch (control) {
+        case ControlInput::IncreaseSpeed:
+        case ControlInput::DecreaseSpeed:
+            return speedRepeatTicks;
+        case ControlInput::Exit:
+            return 0;
+        default:
+            return rotationRepeatTicks;
+    }
+}
+
+HeldControls::HeldControls()
+    : appliedPresses(0),
+      held{},
+      pressed{},
+      ticksSinceApplied{} {
+}
+
+void HeldControls::handle(const HeldControlEvent& event) {
+    const auto index = static_cast<std::size_t>(event.control);
+
+    switch (event.action) {
+        case HeldControlAction::Press:
+            // Presses of a key already held are OS repeats, which the tick rate replaces
+            if (!held[index]) {
+                held[index] = true;
+                pressed[index] = true;
+                pressTimes[index] = event.time;
+            }
+            break;
+        case HeldControlAction::Release:
+            held[index] = false;
+            break;
+        case HeldControlAction::ReleaseAll:
+            held.fill(false);
+            break;
+    }
+}
+
+std::size_t HeldControls::due(ControlInput* controls) {
+    std::size_t nDue = 0;
+
+    for (std::size_t index = 0; index < controlInputCount; index++) {
+        const auto control = static_cast<ControlInput>(index);
+
+        if (pressed[index]) {
+            pressed[index] = false;
+            ticksSinceApplied[index] = 0;
+            controls[nDue++] = control;
+
+            if (appliedPresses == 0 || pressTimes[index] > latestPressTime) {
+                latestPressTime = pressTimes[index];
+            }
+            appliedPresses++;
+        } else if (held[index] && repeatTicks(control) > 0 && ++ticksSinceApplied[index] >= repeatTicks(control)) {
+            ticksSinceApplied[index] = 0;
+            controls[nDue++] = control;
+        }
+    }
+
+    return nDue;
+}
@@ -0,0 +1,60 @@
+#ifndef HELD_CONTROLS
+#define HELD_CONTROLS
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "ControlInput.h"
+
+// Measured in ticks, between repeats of a held rotation, theta every 2 ticks is 90°/s at 60 Hz
+constexpr unsigned int rotationRepeatTicks = 2;
+
+// Measured in ticks, between repeats of a held speed change, 6 steps per second at 60 Hz
+constexpr unsigned int speedRepeatTicks = 10;
+
+enum class HeldControlAction : std::uint8_t {
+    Press,
+    Release,
+    // e.g. once the window loses focus, as the keys' releases go elsewhere
+    ReleaseAll
+};
+
+// A key going down or up, handed from the thread receiving key events to the simulation
+struct HeldControlEvent {
+    HeldControlAction action = HeldControlAction::Press;
+    // Ignored by ReleaseAll
+    ControlInput control = ControlInput::Exit;
+    // When the key event was received, for measuring input latency
+    std::chrono::steady_clock::time_point time;
+};
+
+// State of the controls held down, e.g. by keys, turned into controls applied at a steady rate per tick
+// A press applies its control on the next tick, even if released before it, then repeats it every
+// rotationRepeatTicks or speedRepeatTicks ticks for as long as it is held, regardless of the OS key repeat.
+// Exit is applied once per press. Used by the simulation thread only
+class HeldControls {
+public:
+    // Presses applied so far, and when the latest of them was received
+    unsigned long appliedPresses;
+    std::chrono::steady_clock::time_point latestPressTime;
+
+    HeldControls();
+
+    void handle(const HeldControlEvent& event);
+
+    // Writes the controls due on this tick into controls, in ControlInput order, returns how many
+    // Called once per tick, controls needs room for controlInputCount controls
+    std::size_t due(ControlInput* controls);
+
+private:
+    std::array<bool, controlInputCount> held;
+    // Pressed since the previous tick, and not yet applied
+    std::array<bool, controlInputCount> pressed;
+    std::array<std::chrono::steady_clock::time_point, controlInputCount> pressTimes;
+    // Ticks since the control was last applied, while held
+    std::array<unsigned int, controlInputCount> ticksSinceApplied;
+};
+
+#endif
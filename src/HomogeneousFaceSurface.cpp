@@ -1,9 +1,12 @@
 #include "HomogeneousFaceSurface.h"
 
 #include <iomanip>
-#include <fstream>
+#include <string>
 #include <cmath>
 
+#include "TextScanner.h"
+#include "TraceEvents.h"
+
 #ifdef __APPLE__
 #include <OpenGL/gl.h>
 #include <OpenGL/glu.h>
@@ -12,65 +15,55 @@
 #endif
 
 HomogeneousFaceSurface::HomogeneousFaceSurface() {
-    vertices.clear();
-    normals.clear();
 }
 
 bool HomogeneousFaceSurface::readTriangleSoupFile(const char* fileName) {
-    std::ifstream inFile(fileName);
-    if (inFile.bad()) {
+    TRACE_SCOPE("load", "readTriangleSoupFile");
+
+    std::string contents;
+    if (!readWholeFile(fileName, contents)) {
         return false;
     }
+    TextScanner scanner(contents);
 
     // Read in number of triangles and, consequently, vertices
     long nTriangles = 0, nVertices = 0;
-    inFile >> nTriangles;
+    scanner.read(nTriangles);
     nVertices = nTriangles * 3;
 
     // Parse all triangles
-    vertices.resize(nVertices);
+    std::vector<Homogeneous4> vertices(nVertices);
     for (int vertex = 0; vertex < nVertices; vertex++) {
-        inFile >> vertices[vertex].x >> vertices[vertex].y >> vertices[vertex].z;
+        scanner.read(vertices[vertex].x);
+        scanner.read(vertices[vertex].y);
+        scanner.read(vertices[vertex].z);
         // Vertices have v.w = 1.0
         vertices[vertex].w = 1.0;
     }
 
-    computeUnitNormalVectors();
+    mesh.build(vertices);
+    convexHull.compute(vertices);
 
     return true;
 }
 
-void HomogeneousFaceSurface::computeUnitNormalVectors() {
-    // assume that the triangle vertices are set correctly, and allocate one third of that for normals
-    normals.resize(vertices.size() / 3);
-
-    // loop through the triangles, computing normal vectors
-    for (size_t triangle = 0; triangle < normals.size(); triangle++) {
-        const Cartesian3 p = vertices[3 * triangle].Point();
-        const Cartesian3 q = vertices[3 * triangle + 1].Point();
-        const Cartesian3 r = vertices[3 * triangle + 2].Point();
-
-        // compute two edge vectors
-        const Cartesian3 u = q - p;
-        const Cartesian3 v = r - p;
-
-        // compute a normal with the cross-product
-        const Cartesian3 normal = u.cross(v).unit();
-
-        normals[triangle] = Homogeneous4(normal.x, normal.y, normal.z, 0.0);
+void HomogeneousFaceSurface::render(const Matrix4& viewMatrix) const {
+    // Each vertex is transformed once, however many triangles share it
+    thread_local std::vector<Homogeneous4> transformed;
+    transformed.resize(mesh.positions.size());
+    for (size_t vertex = 0; vertex < mesh.positions.size(); vertex++) {
+        transformed[vertex] = viewMatrix * Homogeneous4(mesh.positions[vertex]);
     }
-}
-
 
-void HomogeneousFaceSurface::render(const Matrix4& viewMatrix) const {
     glBegin(GL_TRIANGLES);
 
     // we loop through all of the triangles
-    for (size_t triangle = 0; triangle < normals.size(); triangle++) {
-        Homogeneous4 p = viewMatrix * vertices[3 * triangle];
-        Homogeneous4 q = viewMatrix * vertices[3 * triangle + 1];
-        Homogeneous4 r = viewMatrix * vertices[3 * triangle + 2];
-        Homogeneous4 normal = viewMatrix * normals[triangle];
+    for (size_t triangle = 0; triangle < mesh.normals.size(); triangle++) {
+        const Homogeneous4& p = transformed[mesh.indices[3 * triangle]];
+        const Homogeneous4& q = transformed[mesh.indices[3 * triangle + 1]];
+        const Homogeneous4& r = transformed[mesh.indices[3 * triangle + 2]];
+        const Cartesian3 unitNormal = decodeOctahedralNormal(mesh.normals[triangle]);
+        Homogeneous4 normal = viewMatrix * Homogeneous4(unitNormal.x, unitNormal.y, unitNormal.z, 0.0);
 
         // this works because C++ guarantees that the POD data is in exactly
         // the order stated in the class with no padding.
@@ -82,3 +75,10 @@ void HomogeneousFaceSurface::render(const Matrix4& viewMatrix) const {
 
     glEnd();
 }
+
+MemoryReport HomogeneousFaceSurface::memoryReport() const {
+    MemoryReport report;
+    report.add("mesh.", mesh.memoryReport());
+    report.add("convexHull.vertices", convexHull.vertices);
+    return report;
+}
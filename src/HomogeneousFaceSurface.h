@@ -3,16 +3,19 @@
 
 #include <vector>
 
+#include "ConvexHull.h"
 #include "Homogeneous4.h"
+#include "IndexedMesh.h"
 #include "Matrix4.h"
+#include "MemoryReport.h"
 
 class HomogeneousFaceSurface {
 public:
-    // Each trio of vertices forms a single triangle
-    std::vector<Homogeneous4> vertices;
+    // Welded vertices, indices & normals of the triangles
+    IndexedMesh mesh;
 
-    // normals of the triangles
-    std::vector<Homogeneous4> normals;
+    // convex hull of the vertices, in model coordinates
+    ConvexHull convexHull;
 
     HomogeneousFaceSurface();
 
@@ -20,9 +23,10 @@ public:
     // returns true on success, false otherwise
     bool readTriangleSoupFile(const char* fileName);
 
-    void computeUnitNormalVectors();
-
     void render(const Matrix4& viewMatrix) const;
+
+    // Footprint of mesh & convexHull
+    MemoryReport memoryReport() const;
 };
 
 #endif
@@ -0,0 +1,257 @@
+#include "IndexedMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+#include "TraceEvents.h"
+
+// 1 for positive values and zero, -1 for negative values
+float signNotZero(const float value) {
+    return value < 0.0f ? -1.0f : 1.0f;
+}
+
+OctahedralNormal encodeOctahedralNormal(const Cartesian3& normal) {
+    const float norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    // Degenerate triangles' normals, zero or not a number, encode as +z
+    if (!(norm > 0.0f)) {
+        return {0, 0};
+    }
+
+    float u = normal.x / norm;
+    float v = normal.y / norm;
+    if (normal.z < 0.0f) {
+        const float foldedU = (1.0f - std::abs(v)) * signNotZero(u);
+        v = (1.0f - std::abs(u)) * signNotZero(v);
+        u = foldedU;
+    }
+
+    return {static_cast<std::int16_t>(std::lround(std::clamp(u, -1.0f, 1.0f) * 32767.0f)),
+            static_cast<std::int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f))};
+}
+
+Cartesian3 decodeOctahedralNormal(const OctahedralNormal normal) {
+    float u = std::max(normal.u / 32767.0f, -1.0f);
+    float v = std::max(normal.v / 32767.0f, -1.0f);
+    const float z = 1.0f - std::abs(u) - std::abs(v);
+    if (z < 0.0f) {
+        const float unfoldedU = (1.0f - std::abs(v)) * signNotZero(u);
+        v = (1.0f - std::abs(u)) * signNotZero(v);
+        u = unfoldedU;
+    }
+    return Cartesian3(u, v, z).unit();
+}
+
+void IndexedMesh::build(const std::vector<Homogeneous4>& soup) {
+    TRACE_SCOPE("load", "weldTriangleSoup");
+
+    // Keyed by bit pattern, after adding zero so that -0 and +0 weld as they compare equal
+    struct PositionKey {
+        std::uint32_t x, y, z;
+
+        bool operator==(const PositionKey& other) const {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+    struct PositionHash {
+        std::size_t operator()(const PositionKey& key) const {
+            return (key.x * 0x9E3779B1u) ^ (key.y * 0x85EBCA77u) ^ (key.z * 0xC2B2AE3Du);
+        }
+    };
+    const auto bits = [](const float value) {
+        const float normalized = value + 0.0f;
+        std::uint32_t result;
+        std::memcpy(&result, &normalized, sizeof(result));
+        return result;
+    };
+
+    std::vector<Cartesian3> weldedPositions;
+    std::vector<std::uint32_t> soupIndices(soup.size() - soup.size() % 3);
+    std::unordered_map<PositionKey, std::uint32_t, PositionHash> weldedIndices;
+    weldedIndices.reserve(soupIndices.size());
+    for (std::size_t vertex = 0; vertex < soupIndices.size(); vertex++) {
+        const Cartesian3 position = soup[vertex].Point();
+        const PositionKey key{bits(position.x), bits(position.y), bits(position.z)};
+        const auto [welded, inserted] = weldedIndices.emplace(key, static_cast<std::uint32_t>(weldedPositions.size()));
+        if (inserted) {
+            weldedPositions.push_back(position);
+        }
+        soupIndices[vertex] = welded->second;
+    }
+
+    build(std::move(weldedPositions), std::move(soupIndices));
+}
+
+void IndexedMesh::build(std::vector<Cartesian3> positions, std::vector<std::uint32_t> indices) {
+    TRACE_SCOPE("load", "buildIndexedMesh");
+
+    this->positions = std::move(positions);
+    this->indices = std::move(indices);
+    this->positions.shrink_to_fit();
+    this->indices.shrink_to_fit();
+
+    reorderTriangles();
+    reorderVertices();
+    computeNormals();
+}
+
+void IndexedMesh::reorderTriangles() {
+    const std::size_t nTriangles = triangleCount();
+    const std::size_t nVertices = positions.size();
+    if (nTriangles == 0) {
+        return;
+    }
+
+    // Triangles using each vertex, and how many of them are yet to be emitted
+    std::vector<std::uint32_t> remaining(nVertices, 0);
+    for (const std::uint32_t vertex : indices) {
+        remaining[vertex]++;
+    }
+    std::vector<std::uint32_t> firstTriangle(nVertices + 1, 0);
+    for (std::size_t vertex = 0; vertex < nVertices; vertex++) {
+        firstTriangle[vertex + 1] = firstTriangle[vertex] + remaining[vertex];
+    }
+    std::vector<std::uint32_t> vertexTriangles(3 * nTriangles);
+    std::vector<std::uint32_t> filled(firstTriangle.begin(), firstTriangle.end() - 1);
+    for (std::size_t index = 0; index < 3 * nTriangles; index++) {
+        vertexTriangles[filled[indices[index]]++] = static_cast<std::uint32_t>(index / 3);
+    }
+
+    // Time each vertex last entered the cache, a vertex is cached while less than vertexCacheSize entries have entered
+    // it since, which never happened to any vertex at first
+    constexpr long cacheSize = static_cast<long>(vertexCacheSize);
+    std::vector<long> cacheTimes(nVertices, 0);
+    long time = cacheSize + 1;
+
+    std::vector<bool> emitted(nTriangles, false);
+    std::vector<std::uint32_t> reordered;
+    reordered.reserve(indices.size());
+
+    // Vertices of the emitted triangles, most recent last, to resume from once the fan reaches a dead end
+    std::vector<std::uint32_t> deadEnds;
+    std::vector<std::uint32_t> candidates;
+    std::size_t nextVertex = 0;
+
+    long fan = 0;
+    while (fan >= 0) {
+        // Emit every triangle left around the fan's vertex
+        candidates.clear();
+        for (std::uint32_t entry = firstTriangle[fan]; entry < firstTriangle[fan + 1]; entry++) {
+            const std::uint32_t triangle = vertexTriangles[entry];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = true;
+
+            for (int corner = 0; corner < 3; corner++) {
+                const std::uint32_t vertex = indices[3 * triangle + corner];
+                reordered.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                remaining[vertex]--;
+                if (time - cacheTimes[vertex] > cacheSize) {
+                    cacheTimes[vertex] = time++;
+                }
+            }
+        }
+
+        // Next, the oldest candidate that would still be cached once its triangles are emitted
+        // or, failing that, any cached candidate with triangles left
+        fan = -1;
+        long bestPriority = -1;
+        for (const std::uint32_t vertex : candidates) {
+            if (remaining[vertex] == 0) {
+                continue;
+            }
+            long priority = 0;
+            if (time - cacheTimes[vertex] + 2 * static_cast<long>(remaining[vertex]) <= cacheSize) {
+                priority = time - cacheTimes[vertex];
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                fan = vertex;
+            }
+        }
+
+        // At a dead end, the most recently used vertex with triangles left, then the first one in index order
+        while (fan < 0 && !deadEnds.empty()) {
+            const std::uint32_t vertex = deadEnds.back();
+            deadEnds.pop_back();
+            if (remaining[vertex] > 0) {
+                fan = vertex;
+            }
+        }
+        while (fan < 0 && nextVertex < nVertices) {
+            if (remaining[nextVertex] > 0) {
+                fan = static_cast<long>(nextVertex);
+            }
+            nextVertex++;
+        }
+    }
+
+    indices = std::move(reordered);
+}
+
+void IndexedMesh::reorderVertices() {
+    constexpr std::uint32_t unused = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<std::uint32_t> newIndices(positions.size(), unused);
+    std::vector<Cartesian3> reordered;
+    reordered.reserve(positions.size());
+    for (std::uint32_t& index : indices) {
+        if (newIndices[index] == unused) {
+            newIndices[index] = static_cast<std::uint32_t>(reordered.size());
+            reordered.push_back(positions[index]);
+        }
+        index = newIndices[index];
+    }
+
+    // Vertices no triangle uses are dropped
+    reordered.shrink_to_fit();
+    positions = std::move(reordered);
+}
+
+void IndexedMesh::computeNormals() {
+    normals.resize(triangleCount());
+    normals.shrink_to_fit();
+
+    for (std::size_t triangle = 0; triangle < normals.size(); triangle++) {
+        const Cartesian3& p = positions[indices[3 * triangle]];
+        const Cartesian3& q = positions[indices[3 * triangle + 1]];
+        const Cartesian3& r = positions[indices[3 * triangle + 2]];
+
+        // compute a normal with the cross-product of two edge vectors
+        normals[triangle] = encodeOctahedralNormal((q - p).cross(r - p).unit());
+    }
+}
+
+float IndexedMesh::averageCacheMissRatio(const std::size_t cacheSize) const {
+    if (indices.empty()) {
+        return 0.0f;
+    }
+
+    // Ring of the latest cacheSize vertices transformed
+    std::vector<std::uint32_t> cache(cacheSize, std::numeric_limits<std::uint32_t>::max());
+    std::size_t oldest = 0;
+    std::size_t misses = 0;
+    for (const std::uint32_t index : indices) {
+        if (std::find(cache.begin(), cache.end(), index) == cache.end()) {
+            cache[oldest] = index;
+            oldest = (oldest + 1) % cacheSize;
+            misses++;
+        }
+    }
+
+    return static_cast<float>(misses) / triangleCount();
+}
+
+MemoryReport IndexedMesh::memoryReport() const {
+    MemoryReport report;
+    report.add("positions", positions);
+    report.add("indices", indices);
+    report.add("normals", normals);
+    return report;
+}
@@ -0,0 +1,66 @@
+#ifndef INDEXED_MESH
+#define INDEXED_MESH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Cartesian3.h"
+#include "Homogeneous4.h"
+#include "MemoryReport.h"
+
+// Entries of the post-transform vertex cache triangles are ordered for
+constexpr std::size_t vertexCacheSize = 32;
+
+// Unit vector projected onto an octahedron, whose lower half is folded over the upper one onto a square,
+// stored as two signed normalized 16 bit coordinates, a quarter of a Homogeneous4
+struct OctahedralNormal {
+    std::int16_t u;
+    std::int16_t v;
+};
+
+OctahedralNormal encodeOctahedralNormal(const Cartesian3& normal);
+
+// Unit vector, within about 1e-4 radians of the encoded one
+Cartesian3 decodeOctahedralNormal(OctahedralNormal normal);
+
+// Triangles sharing their vertices, built from a triangle soup or from triangles already indexed
+// Triangles are ordered for the locality of a vertexCacheSize entry vertex cache, following Sander et al.'s
+// Tipsify, fanning around one vertex after another in linear time, then vertices in their order of first use
+class IndexedMesh {
+public:
+    // Distinct vertices, packed as three floats
+    std::vector<Cartesian3> positions;
+
+    // Three per triangle, in the winding order they were given in
+    std::vector<std::uint32_t> indices;
+
+    // Unit normal per triangle
+    std::vector<OctahedralNormal> normals;
+
+    // Each trio of soup vertices forms a single triangle, exactly coincident vertices are welded
+    void build(const std::vector<Homogeneous4>& soup);
+
+    // Each trio of indices into positions forms a single triangle
+    void build(std::vector<Cartesian3> positions, std::vector<std::uint32_t> indices);
+
+    std::size_t triangleCount() const {
+        return indices.size() / 3;
+    }
+
+    // Average vertices transformed per triangle, through a first in first out cache of cacheSize entries
+    // 3 for a triangle soup, approaching 0.5 for a large regular grid in its best order
+    float averageCacheMissRatio(std::size_t cacheSize = vertexCacheSize) const;
+
+    // Footprint of positions, indices & normals
+    MemoryReport memoryReport() const;
+
+private:
+    void reorderTriangles();
+
+    void reorderVertices();
+
+    void computeNormals();
+};
+
+#endif
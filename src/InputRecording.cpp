@@ -0,0 +1,213 @@
+#include "InputRecording.h"
+
+#include <cstring>
+
+constexpr char recordingMagic[4] = {'B', 'F', 'R', 'C'};
+// Version 2: lava bombs draw from the scene's own generator
+// Version 3: explosions spawn from every lava bomb that died, no longer skipping those next to another
+// Version 4: aircraft count
+constexpr std::uint16_t recordingVersion = 4;
+
+// Event kinds besides ControlInput values
+constexpr std::uint8_t lavaBombBudgetEvent = 0xFE;
+constexpr std::uint8_t stateHashEvent = 0xFF;
+
+// Copies value as is, which is little-endian on every platform the application builds for
+template <typename T>
+void writeValue(std::ofstream& outFile, const T& value) {
+    outFile.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& inFile, T& value) {
+    return static_cast<bool>(inFile.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// 7 bits per byte, least significant first, high bit set on every byte but the last
+void writeVarint(std::ofstream& outFile, unsigned long value) {
+    while (value >= 0x80) {
+        outFile.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    outFile.put(static_cast<char>(value));
+}
+
+bool readVarint(std::ifstream& inFile, unsigned long& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const int byte = inFile.get();
+        if (byte == std::char_traits<char>::eof()) {
+            return false;
+        }
+        value |= static_cast<unsigned long>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+InputRecorder::InputRecorder()
+    : previousTick(0) {
+}
+
+bool InputRecorder::open(const char* fileName, const RecordingHeader& header) {
+    outFile.open(fileName, std::ios::binary | std::ios::trunc);
+    if (!outFile.good()) {
+        return false;
+    }
+
+    outFile.write(recordingMagic, sizeof(recordingMagic));
+    writeValue(outFile, recordingVersion);
+    writeValue(outFile, header.seed);
+    writeValue(outFile, header.timeStep);
+    writeValue(outFile, header.initialPosition);
+    writeValue(outFile, static_cast<std::uint16_t>(header.obstacleFileName.size()));
+    outFile.write(header.obstacleFileName.data(), static_cast<std::streamsize>(header.obstacleFileName.size()));
+    writeValue(outFile, header.aircraftCount);
+
+    previousTick = 0;
+    return outFile.good();
+}
+
+void InputRecorder::close() {
+    if (outFile.is_open()) {
+        outFile.close();
+    }
+}
+
+bool InputRecorder::isOpen() const {
+    return outFile.is_open();
+}
+
+void InputRecorder::writeEventStart(const unsigned long tick, const std::uint8_t kind) {
+    writeVarint(outFile, tick - previousTick);
+    outFile.put(static_cast<char>(kind));
+    previousTick = tick;
+}
+
+void InputRecorder::recordControl(const unsigned long tick, const ControlInput control) {
+    writeEventStart(tick, static_cast<std::uint8_t>(control));
+}
+
+void InputRecorder::recordLavaBombBudget(const unsigned long tick, const LavaBombBudget& budget) {
+    writeEventStart(tick, lavaBombBudgetEvent);
+    writeValue(outFile, budget.spawnInterval);
+    writeValue(outFile, static_cast<std::uint32_t>(budget.explosionFanOut));
+    writeValue(outFile, static_cast<std::uint32_t>(budget.maximumLiveLavaBombs));
+}
+
+void InputRecorder::recordStateHash(const unsigned long tick, const std::uint32_t hash) {
+    writeEventStart(tick, stateHashEvent);
+    writeValue(outFile, hash);
+}
+
+InputReplay::InputReplay()
+    : nextEvent(0),
+      nVerified(0) {
+}
+
+bool InputReplay::readRecordingFile(const char* fileName) {
+    std::ifstream inFile(fileName, std::ios::binary);
+    if (!inFile.good()) {
+        return false;
+    }
+
+    char magic[sizeof(recordingMagic)];
+    std::uint16_t version = 0;
+    std::uint16_t obstacleFileNameLength = 0;
+    if (!inFile.read(magic, sizeof(magic)) || std::memcmp(magic, recordingMagic, sizeof(magic)) != 0 ||
+        !readValue(inFile, version) || version != recordingVersion ||
+        !readValue(inFile, header.seed) ||
+        !readValue(inFile, header.timeStep) ||
+        !readValue(inFile, header.initialPosition) ||
+        !readValue(inFile, obstacleFileNameLength)) {
+        return false;
+    }
+
+    header.obstacleFileName.resize(obstacleFileNameLength);
+    if (!inFile.read(header.obstacleFileName.data(), obstacleFileNameLength) ||
+        !readValue(inFile, header.aircraftCount)) {
+        return false;
+    }
+
+    events.clear();
+    nextEvent = 0;
+    nVerified = 0;
+
+    unsigned long tick = 0;
+    unsigned long tickDelta = 0;
+    while (readVarint(inFile, tickDelta)) {
+        RecordedEvent event{};
+        tick += tickDelta;
+        event.tick = tick;
+
+        const int kind = inFile.get();
+        if (kind == std::char_traits<char>::eof()) {
+            return false;
+        }
+        event.kind = static_cast<std::uint8_t>(kind);
+
+        if (event.kind == stateHashEvent) {
+            if (!readValue(inFile, event.hash)) {
+                return false;
+            }
+        } else if (event.kind == lavaBombBudgetEvent) {
+            std::uint32_t explosionFanOut = 0;
+            std::uint32_t maximumLiveLavaBombs = 0;
+            if (!readValue(inFile, event.budget.spawnInterval) ||
+                !readValue(inFile, explosionFanOut) ||
+                !readValue(inFile, maximumLiveLavaBombs)) {
+                return false;
+            }
+            event.budget.explosionFanOut = explosionFanOut;
+            event.budget.maximumLiveLavaBombs = maximumLiveLavaBombs;
+        } else if (event.kind <= static_cast<std::uint8_t>(ControlInput::Exit)) {
+            event.control = static_cast<ControlInput>(event.kind);
+        } else {
+            return false;
+        }
+
+        events.push_back(event);
+    }
+
+    return true;
+}
+
+void InputReplay::applyDue(Scene& scene) {
+    while (nextEvent < events.size() && events[nextEvent].tick <= scene.ticks) {
+        const RecordedEvent& event = events[nextEvent++];
+
+        // Hashes not checked through verify are skipped
+        if (event.kind == lavaBombBudgetEvent) {
+            scene.lavaBombBudget = event.budget;
+        } else if (event.kind != stateHashEvent) {
+            scene.applyControl(event.control);
+        }
+    }
+}
+
+bool InputReplay::verify(const Scene& scene) {
+    while (nextEvent < events.size() && events[nextEvent].tick <= scene.ticks &&
+           events[nextEvent].kind == stateHashEvent) {
+        const RecordedEvent& event = events[nextEvent++];
+
+        if (event.tick != scene.ticks || event.hash != scene.stateHash()) {
+            return false;
+        }
+        nVerified++;
+    }
+    return true;
+}
+
+unsigned long InputReplay::lastTick() const {
+    return events.empty() ? 0 : events.back().tick;
+}
+
+bool InputReplay::finished(const Scene& scene) const {
+    return scene.ticks >= lastTick();
+}
+
+unsigned long InputReplay::verifiedTicks() const {
+    return nVerified;
+}
@@ -0,0 +1,102 @@
+#ifndef INPUT_RECORDING
+#define INPUT_RECORDING
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Cartesian3.h"
+#include "ControlInput.h"
+#include "Scene.h"
+
+/*
+ * Recordings hold everything a run depends on besides the assets, so that replaying one reproduces it exactly.
+ *
+ * Binary layout, little-endian:
+ *   header: "BFRC", u16 version, u32 seed, f32 time step, 3 x f32 initial position, u16 length + obstacle file name,
+ *           u32 aircraft count
+ *   events: varint ticks since the previous event, u8 kind, then kind-specific data:
+ *     ControlInput value    (no data)
+ *     lavaBombBudgetEvent   f32 spawn interval, u32 explosion fan-out, u32 maximum live lava bombs
+ *     stateHashEvent        u32 Scene::stateHash
+ * Controls and budgets of tick t are applied before its update, state hashes are taken after it.
+ */
+
+struct RecordingHeader {
+    std::uint32_t seed = 0;
+    // Measured in seconds
+    float timeStep = 0.0f;
+    Cartesian3 initialPosition;
+    // Empty if the run had no obstacles
+    std::string obstacleFileName;
+    // Aircraft spawned by Scene::spawnAircraft before the first tick
+    std::uint32_t aircraftCount = 0;
+};
+
+// Logs the inputs of a run, and the state hash after each of its ticks, as they happen
+class InputRecorder {
+public:
+    InputRecorder();
+
+    // returns true on success, false otherwise
+    bool open(const char* fileName, const RecordingHeader& header);
+
+    void close();
+
+    bool isOpen() const;
+
+    // tick is Scene::ticks when the control is applied, i.e. before the update
+    void recordControl(unsigned long tick, ControlInput control);
+
+    void recordLavaBombBudget(unsigned long tick, const LavaBombBudget& budget);
+
+    // tick is Scene::ticks after the update
+    void recordStateHash(unsigned long tick, std::uint32_t hash);
+
+private:
+    std::ofstream outFile;
+    unsigned long previousTick;
+
+    void writeEventStart(unsigned long tick, std::uint8_t kind);
+};
+
+struct RecordedEvent {
+    unsigned long tick;
+    std::uint8_t kind;
+    ControlInput control;
+    LavaBombBudget budget;
+    std::uint32_t hash;
+};
+
+// Plays the inputs of a recording back into a Scene, checking its state hashes along the way
+class InputReplay {
+public:
+    RecordingHeader header;
+    std::vector<RecordedEvent> events;
+
+    InputReplay();
+
+    // returns true on success, false otherwise
+    bool readRecordingFile(const char* fileName);
+
+    // Applies the inputs due before scene's next update
+    void applyDue(Scene& scene);
+
+    // Checks the state hashes recorded up to scene's latest tick, returns false on divergence
+    bool verify(const Scene& scene);
+
+    // Tick of the last event, replaying past it reproduces nothing more
+    unsigned long lastTick() const;
+
+    bool finished(const Scene& scene) const;
+
+    // Number of state hashes that matched so far
+    unsigned long verifiedTicks() const;
+
+private:
+    size_t nextEvent;
+    unsigned long nVerified;
+};
+
+#endif
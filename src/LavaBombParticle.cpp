@@ -1,33 +1,104 @@
 #include "LavaBombParticle.h"
 
-#include "SphereCollision.h"
-#include "Random.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 // Measured in seconds, this allows to compute it as sum of timeSteps
 constexpr float minimumLifespan = 3.0f;
 
-LavaBombParticle::LavaBombParticle(const Cartesian3& initialPosition, const Terrain* terrain)
-    : position(initialPosition),
+// Lava bombs still airborne after this many seconds are retired regardless
+constexpr float maximumLandingLifespan = 600.0f;
+// Bisection steps used to narrow down the landing lifespan once a colliding sample is found
+constexpr int landingRefinementSteps = 12;
+
+LavaBombParticle::LavaBombParticle(const LavaBombId id,
+                                   const Cartesian3& initialPosition,
+                                   const Cartesian3& initialVelocity,
+                                   const Terrain& terrain,
+                                   const ObstacleLayer& obstacles)
+    : id(id),
+      position(initialPosition),
+      previousPosition(initialPosition),
       isAlive(true),
-      terrain(terrain),
+      initialPosition(initialPosition),
+      initialVelocity(initialVelocity),
       lifespan(0.0f) {
-    const float speed = randomRange(minParticleSpeed, maxParticleSpeed);
-    const Cartesian3 direction = randomUnitVectorInUpwardsCone(directionAngleRange, 0.5f, 2.0f).unit();
-    velocity = speed * direction;
+    landingLifespan = predictLandingLifespan(terrain, obstacles);
 }
 
-void LavaBombParticle::update(float timeStep) {
-    lifespan += timeStep;
+LavaBombParticle::LavaBombParticle()
+    : id(0),
+      isAlive(false),
+      landingLifespan(0.0f),
+      lifespan(0.0f) {
+}
 
-    // Make gravity only affect the vertical axis
-    velocity[2] = velocity[2] - gravity * timeStep;
+template <typename T>
+void writeLavaBombField(StateWriter& writer, const std::vector<LavaBombParticle>& lavaBombs,
+                        T LavaBombParticle::*field) {
+    std::uint8_t* destination = writer.append(lavaBombs.size() * sizeof(T));
+    for (const auto& lavaBomb : lavaBombs) {
+        std::memcpy(destination, &(lavaBomb.*field), sizeof(T));
+        destination += sizeof(T);
+    }
+}
+
+template <typename T>
+bool readLavaBombField(StateReader& reader, std::vector<LavaBombParticle>& lavaBombs, T LavaBombParticle::*field) {
+    const std::uint8_t* source = reader.take(lavaBombs.size() * sizeof(T));
+    if (!source) {
+        return false;
+    }
+    for (auto& lavaBomb : lavaBombs) {
+        std::memcpy(&(lavaBomb.*field), source, sizeof(T));
+        source += sizeof(T);
+    }
+    return true;
+}
+
+void LavaBombParticle::writeState(StateWriter& writer, const std::vector<LavaBombParticle>& lavaBombs) {
+    writer.write(static_cast<std::uint32_t>(lavaBombs.size()));
+    writeLavaBombField(writer, lavaBombs, &LavaBombParticle::id);
+    writeLavaBombField(writer, lavaBombs, &LavaBombParticle::position);
+    writeLavaBombField(writer, lavaBombs, &LavaBombParticle::previousPosition);
+    writeLavaBombField(writer, lavaBombs, &LavaBombParticle::isAlive);
+    writeLavaBombField(writer, lavaBombs, &LavaBombParticle::landingLifespan);
+    writeLavaBombField(writer, lavaBombs, &LavaBombParticle::initialPosition);
+    writeLavaBombField(writer, lavaBombs, &LavaBombParticle::initialVelocity);
+    writeLavaBombField(writer, lavaBombs, &LavaBombParticle::lifespan);
+}
+
+bool LavaBombParticle::readState(StateReader& reader, std::vector<LavaBombParticle>& lavaBombs) {
+    std::uint32_t count = 0;
+    // Every lava bomb takes more than a byte, which bounds count before allocating for it
+    if (!reader.read(count) || count > static_cast<std::size_t>(reader.end - reader.position)) {
+        return false;
+    }
+    lavaBombs.assign(count, LavaBombParticle());
 
-    position = position + velocity * timeStep;
+    return readLavaBombField(reader, lavaBombs, &LavaBombParticle::id) &&
+           readLavaBombField(reader, lavaBombs, &LavaBombParticle::position) &&
+           readLavaBombField(reader, lavaBombs, &LavaBombParticle::previousPosition) &&
+           readLavaBombField(reader, lavaBombs, &LavaBombParticle::isAlive) &&
+           readLavaBombField(reader, lavaBombs, &LavaBombParticle::landingLifespan) &&
+           readLavaBombField(reader, lavaBombs, &LavaBombParticle::initialPosition) &&
+           readLavaBombField(reader, lavaBombs, &LavaBombParticle::initialVelocity) &&
+           readLavaBombField(reader, lavaBombs, &LavaBombParticle::lifespan);
+}
 
-    checkTerrainCollision();
+void LavaBombParticle::update(const float timeStep) {
+    lifespan += timeStep;
+    previousPosition = position;
+    position = positionAt(lifespan);
+}
+
+Cartesian3 LavaBombParticle::positionAt(const float t) const {
+    // Make gravity only affect the vertical axis
+    return initialPosition + initialVelocity * t + Cartesian3(0.0f, 0.0f, -0.5f * gravity * t * t);
 }
 
-void LavaBombParticle::checkTerrainCollision() {
+bool LavaBombParticle::isTerrainCollision(const Terrain& terrain, const float t) const {
     /*
      * We check collision against terrain by seeing if the LavaBombParticle position projected
      * onto the terrain is within lava bomb's radius.
@@ -38,21 +109,100 @@ void LavaBombParticle::checkTerrainCollision() {
      *
      * This logic purposefully bypasses the age check as it's not required.
      */
-    if (const Cartesian3 terrainPoint(position.x, position.y, terrain->getHeight(position.x, position.y));
-        isSpherePointCollision(this->position, lavaBombRadius, terrainPoint)) {
-        isAlive = false;
+    const Cartesian3 p = positionAt(t);
+    const Cartesian3 terrainPoint(p.x, p.y, terrain.getHeight(p.x, p.y));
+    return isSpherePointCollision(p, lavaBombRadius, terrainPoint);
+}
+
+bool LavaBombParticle::isLandingCollision(const Terrain& terrain, const ObstacleLayer& obstacles,
+                                          const float t) const {
+    return isTerrainCollision(terrain, t) || obstacles.isSphereCollision(positionAt(t), lavaBombRadius);
+}
+
+float LavaBombParticle::predictLandingLifespan(const Terrain& terrain, const ObstacleLayer& obstacles) const {
+    /*
+     * March along the ballistic path until the terrain or an obstacle is within lavaBombRadius of the lava bomb.
+     *
+     * The collision band |z - getHeight(x, y)| <= lavaBombRadius is 2 * lavaBombRadius wide, so steps
+     * are sized for the height above terrain to change by at most lavaBombRadius, which can't skip it.
+     * Over a step dt that change is bounded by (|vz| + maximumSlope * |vxy|) * dt + gravity * dt^2 / 2.
+     *
+     * Obstacles additionally limit steps to lavaBombRadius of travel, so consecutive samples overlap.
+     *
+     * Lava bombs leaving the heightfield or falling below everything they could land on are retired then,
+     * as they would fall forever otherwise, taking up lavaBombBudget.
+     */
+    const float horizontalSpeed = std::sqrt(initialVelocity.x * initialVelocity.x +
+                                            initialVelocity.y * initialVelocity.y);
+    const float a = 0.5f * gravity;
+    const float lowestPoint = std::min(terrain.minimumHeight, obstacles.bounds().minimum.z);
+
+    float previousT = 0.0f;
+    float t = 0.0f;
+    while (t < maximumLandingLifespan) {
+        const Cartesian3 p = positionAt(t);
+        if (!terrain.contains(p.x, p.y)) {
+            return t;
+        }
+
+        if (isLandingCollision(terrain, obstacles, t)) {
+            if (t == 0.0f) {
+                return t;
+            }
+
+            // previousT is known to be clear of the terrain, bisect towards the first colliding lifespan
+            float clear = previousT;
+            float colliding = t;
+            for (int step = 0; step < landingRefinementSteps; step++) {
+                const float middle = 0.5f * (clear + colliding);
+                if (isLandingCollision(terrain, obstacles, middle)) {
+                    colliding = middle;
+                } else {
+                    clear = middle;
+                }
+            }
+            return colliding;
+        }
+
+        const float verticalSpeed = initialVelocity.z - gravity * t;
+
+        // Falling below the lowest point of the terrain and obstacles means they can't be reached anymore
+        if (verticalSpeed < 0.0f && p.z < lowestPoint - lavaBombRadius) {
+            return t;
+        }
+
+        // Largest dt satisfying a * dt^2 + b * dt <= lavaBombRadius
+        const float b = std::abs(verticalSpeed) + terrain.maximumSlope * horizontalSpeed;
+        float dt = (-b + std::sqrt(b * b + 4.0f * a * lavaBombRadius)) / (2.0f * a);
+
+        if (!obstacles.empty()) {
+            const float speed = std::sqrt(horizontalSpeed * horizontalSpeed + verticalSpeed * verticalSpeed);
+            dt = std::min(dt, lavaBombRadius / (speed + gravity * dt));
+        }
+
+        previousT = t;
+        t += dt;
     }
+
+    return maximumLandingLifespan;
 }
 
-void LavaBombParticle::checkCollision(LavaBombParticle& other) {
-    if (lifespan < minimumLifespan || other.lifespan < minimumLifespan) {
-        return;
+std::size_t LavaBombParticle::findCollisions(const std::vector<LavaBombParticle>& lavaBombs,
+                                             const PointSpan& positions, std::uint32_t* hits) const {
+    if (lifespan < minimumLifespan) {
+        return 0;
     }
 
-    if (isSphereSphereCollision(
-        this->position, lavaBombRadius,
-        other.position, lavaBombRadius)) {
-        isAlive = false;
-        other.isAlive = false;
+    const std::size_t nHits = allSphereSphereCollisions(position, lavaBombRadius, positions, lavaBombRadius, hits);
+
+    std::size_t nCollisions = 0;
+    for (std::size_t hit = 0; hit < nHits; hit++) {
+        const LavaBombParticle& other = lavaBombs[hits[hit]];
+
+        // Avoid self-collisions
+        if (&other != this && other.lifespan >= minimumLifespan) {
+            hits[nCollisions++] = hits[hit];
+        }
     }
+    return nCollisions;
 }
@@ -1,12 +1,21 @@
 #ifndef LAVA_BOMB_PARTICLE
 #define LAVA_BOMB_PARTICLE
 
+#include <cstdint>
+#include <vector>
+
 #include "Cartesian3.h"
+#include "ObstacleLayer.h"
+#include "SceneState.h"
+#include "SphereCollision.h"
 #include "Terrain.h"
 
 // Measured in meters/seconds
 typedef float ParticleSpeed;
 
+// Identifies a LavaBombParticle across its lifetime, assigned in spawn order
+typedef unsigned int LavaBombId;
+
 constexpr ParticleSpeed minParticleSpeed = 60.0f;
 constexpr ParticleSpeed maxParticleSpeed = 300.0f;
 constexpr float directionAngleRange = 45.0f;
@@ -17,21 +26,54 @@ constexpr float lavaBombRadius = 100.0f;
 
 class LavaBombParticle {
 public:
-    LavaBombParticle(const Cartesian3& initialPosition, const Terrain* terrain);
+    // initialVelocity is measured in meters/seconds, see Random::upwardsConeVelocities
+    LavaBombParticle(LavaBombId id, const Cartesian3& initialPosition, const Cartesian3& initialVelocity,
+                     const Terrain& terrain, const ObstacleLayer& obstacles);
+
+    // Placeholder to read a saved state into, see readState
+    LavaBombParticle();
 
+    LavaBombId id;
     Cartesian3 position;
+    // Position before the latest update
+    Cartesian3 previousPosition;
     bool isAlive;
 
+    // Lifespan at which the lava bomb collides with the terrain or an obstacle, predicted on spawn
+    // Or at which it leaves the heightfield, falls below both, or has flown for maximumLandingLifespan
+    // Lava bombs are not checked against either afterwards, the owner retires them once it elapses
+    float landingLifespan;
+
     void update(float timeStep);
 
-    void checkCollision(LavaBombParticle& other);
+    // Writes the indices of the other lava bombs of lavaBombs it collides with into hits, returns how many
+    // lavaBombs' positions are laid out in the same order, hits needs room for lavaBombs.size() indices
+    // Lava bombs colliding with one another both die, so whether one dies only depends on the others' positions
+    // and lifespans, not on which collided first, and lava bombs can be checked in any order or concurrently
+    std::size_t findCollisions(const std::vector<LavaBombParticle>& lavaBombs, const PointSpan& positions,
+                               std::uint32_t* hits) const;
+
+    // Writes every field of every lava bomb, field by field, so that the fields that stay constant over
+    // a lava bomb's lifetime line up between consecutive states of a scene
+    static void writeState(StateWriter& writer, const std::vector<LavaBombParticle>& lavaBombs);
+
+    // Reads lava bombs written by writeState, replacing lavaBombs
+    // returns true on success, false if the state is malformed
+    static bool readState(StateReader& reader, std::vector<LavaBombParticle>& lavaBombs);
 
 private:
-    Cartesian3 velocity;
-    const Terrain* terrain;
+    Cartesian3 initialPosition;
+    Cartesian3 initialVelocity;
     float lifespan;
 
-    void checkTerrainCollision();
+    // Closed form of the ballistic path, t measured in seconds since spawn
+    Cartesian3 positionAt(float t) const;
+
+    float predictLandingLifespan(const Terrain& terrain, const ObstacleLayer& obstacles) const;
+
+    bool isTerrainCollision(const Terrain& terrain, float t) const;
+
+    bool isLandingCollision(const Terrain& terrain, const ObstacleLayer& obstacles, float t) const;
 };
 
 #endif
@@ -0,0 +1,46 @@
+#ifndef LOCK_FREE_QUEUE
+#define LOCK_FREE_QUEUE
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded FIFO for exactly one producer thread and one consumer thread
+// Neither side ever waits on the other, push fails instead when the queue is full
+template <typename T, std::size_t Capacity>
+class LockFreeQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+public:
+    // Producer only, returns false if the queue is full
+    bool push(const T& value) {
+        const std::size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+
+        entries[currentTail & (Capacity - 1)] = value;
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, returns false if the queue is empty
+    bool pop(T& value) {
+        const std::size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        value = entries[currentHead & (Capacity - 1)];
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> entries{};
+    // Monotonic counters, kept on separate cache lines since each is written by a different thread
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+};
+
+#endif
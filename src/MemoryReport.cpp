@@ -0,0 +1,56 @@
+#include "MemoryReport.h"
+
+#include <iomanip>
+
+std::size_t MemoryEntry::usedBytes() const {
+    return size * elementSize;
+}
+
+std::size_t MemoryEntry::reservedBytes() const {
+    return capacity * elementSize;
+}
+
+void MemoryReport::add(const std::string& name, const std::size_t elementSize, const std::size_t size,
+                       const std::size_t capacity, const std::size_t peakSize) {
+    entries.push_back({name, elementSize, size, capacity, peakSize});
+}
+
+void MemoryReport::add(const std::string& prefix, const MemoryReport& other) {
+    for (const MemoryEntry& entry : other.entries) {
+        entries.push_back(entry);
+        entries.back().name = prefix + entry.name;
+    }
+}
+
+std::size_t MemoryReport::usedBytes() const {
+    std::size_t bytes = 0;
+    for (const MemoryEntry& entry : entries) {
+        bytes += entry.usedBytes();
+    }
+    return bytes;
+}
+
+std::size_t MemoryReport::reservedBytes() const {
+    std::size_t bytes = 0;
+    for (const MemoryEntry& entry : entries) {
+        bytes += entry.reservedBytes();
+    }
+    return bytes;
+}
+
+void MemoryReport::print(std::ostream& outStream) const {
+    const auto kib = [](const std::size_t bytes) { return static_cast<double>(bytes) / 1024.0; };
+
+    outStream << std::fixed << std::setprecision(1);
+    outStream << "  " << std::left << std::setw(40) << "buffer" << std::right << std::setw(8) << "element"
+              << std::setw(12) << "size" << std::setw(12) << "capacity" << std::setw(12) << "peak"
+              << std::setw(12) << "used KiB" << std::setw(14) << "reserved KiB" << std::endl;
+    for (const MemoryEntry& entry : entries) {
+        outStream << "  " << std::left << std::setw(40) << entry.name << std::right << std::setw(8) << entry.elementSize
+                  << std::setw(12) << entry.size << std::setw(12) << entry.capacity << std::setw(12) << entry.peakSize
+                  << std::setw(12) << kib(entry.usedBytes()) << std::setw(14) << kib(entry.reservedBytes())
+                  << std::endl;
+    }
+    outStream << "  " << std::left << std::setw(84) << "total" << std::right
+              << std::setw(12) << kib(usedBytes()) << std::setw(14) << kib(reservedBytes()) << std::endl;
+}
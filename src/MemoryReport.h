@@ -0,0 +1,61 @@
+#ifndef MEMORY_REPORT
+#define MEMORY_REPORT
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Heap footprint of a single buffer
+struct MemoryEntry {
+    std::string name;
+    // Measured in bytes
+    std::size_t elementSize;
+    // Elements in use
+    std::size_t size;
+    // Elements allocated
+    std::size_t capacity;
+    // Most elements in use at once, as far as the owner tracks it, size otherwise
+    std::size_t peakSize;
+
+    // Measured in bytes
+    std::size_t usedBytes() const;
+
+    // Measured in bytes
+    std::size_t reservedBytes() const;
+};
+
+// Heap footprint of an object, broken down by buffer
+// Buffers are listed by their owners' memoryReport, objects' own sizes are not included
+class MemoryReport {
+public:
+    std::vector<MemoryEntry> entries;
+
+    void add(const std::string& name, std::size_t elementSize, std::size_t size, std::size_t capacity,
+             std::size_t peakSize);
+
+    // std::vector never releases capacity, so capacity is its peak footprint
+    template <typename T>
+    void add(const std::string& name, const std::vector<T>& buffer) {
+        add(name, sizeof(T), buffer.size(), buffer.capacity(), buffer.size());
+    }
+
+    template <typename T>
+    void add(const std::string& name, const std::vector<T>& buffer, const std::size_t peakSize) {
+        add(name, sizeof(T), buffer.size(), buffer.capacity(), peakSize);
+    }
+
+    // Adds the entries of other, with prefix prepended to their names
+    void add(const std::string& prefix, const MemoryReport& other);
+
+    // Measured in bytes
+    std::size_t usedBytes() const;
+
+    // Measured in bytes
+    std::size_t reservedBytes() const;
+
+    // Prints a table of every entry, followed by the totals, sizes in KiB
+    void print(std::ostream& outStream) const;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "MultiplayerClient.h"
+
+#include <cmath>
+
+MultiplayerClient::MultiplayerClient()
+    : clientId(0),
+      aircraft(0),
+      joined(false),
+      datagram(maximumDatagramSize) {
+}
+
+bool MultiplayerClient::open(const UdpAddress& server) {
+    this->server = server;
+    if (!socket.open()) {
+        return false;
+    }
+    join();
+    return true;
+}
+
+void MultiplayerClient::join() {
+    const std::uint8_t message = static_cast<std::uint8_t>(MessageType::Join);
+    socket.send(server, &message, sizeof(message));
+}
+
+void MultiplayerClient::sendInput(const float speed, const float climbRate, const float turnDegrees) {
+    buffer.clear();
+    ByteWriter writer(buffer);
+    writer.writeByte(static_cast<std::uint8_t>(MessageType::Input));
+    writer.writeVarint(clientId);
+    writer.writeVarint(state.tick);
+    writer.writeSigned(std::lround(speed / steeringQuantum));
+    writer.writeSigned(std::lround(climbRate / steeringQuantum));
+    writer.writeSigned(std::lround(turnDegrees / steeringQuantum));
+    socket.send(server, buffer.data(), buffer.size());
+}
+
+int MultiplayerClient::receive() {
+    int nSnapshots = 0;
+
+    UdpAddress source;
+    long size = 0;
+    while ((size = socket.receive(source, datagram.data(), datagram.size())) >= 0) {
+        ByteReader reader(datagram.data(), static_cast<std::size_t>(size));
+        std::uint8_t type = 0;
+        if (!(source == server) || !reader.readByte(type)) {
+            continue;
+        }
+
+        if (type == static_cast<std::uint8_t>(MessageType::Welcome)) {
+            std::uint64_t id = 0, aircraftId = 0;
+            if (reader.readVarint(id) && reader.readVarint(aircraftId)) {
+                clientId = static_cast<std::uint32_t>(id);
+                aircraft = static_cast<AircraftId>(aircraftId);
+                joined = true;
+            }
+            continue;
+        }
+        if (type != static_cast<std::uint8_t>(MessageType::Snapshot)) {
+            continue;
+        }
+
+        SnapshotHeader header;
+        if (!readSnapshotHeader(reader, header)) {
+            statistics.snapshotsDiscarded++;
+            continue;
+        }
+
+        // Baselines must still be kept, and not in the slot about to be overwritten
+        const NetworkSnapshot& baseline = received[header.baselineTick % snapshotHistory];
+        const bool hasBaseline = baseline.tick == header.baselineTick && header.tick > header.baselineTick &&
+                                 header.tick - header.baselineTick < snapshotHistory;
+        if (header.baselineTick != 0 && !hasBaseline) {
+            statistics.snapshotsDiscarded++;
+            continue;
+        }
+
+        NetworkSnapshot& snapshot = received[header.tick % snapshotHistory];
+        if (!readSnapshotEntities(reader, header.baselineTick != 0 ? &baseline : nullptr, snapshot)) {
+            // Leaves no stale snapshot behind the slot's tick
+            snapshot.tick = 0;
+            statistics.snapshotsDiscarded++;
+            continue;
+        }
+        snapshot.tick = header.tick;
+
+        // Snapshots may arrive out of order, the state only moves forward
+        if (snapshot.tick > state.tick) {
+            state = snapshot;
+        }
+
+        nSnapshots++;
+        statistics.snapshotsReceived++;
+        statistics.bytesReceived += static_cast<unsigned long>(size);
+        statistics.latencies.push_back(static_cast<float>(steadyClockNanoseconds() - header.sendTime) / 1e6f);
+    }
+
+    return nSnapshots;
+}
+
+bool MultiplayerClient::wait(const int timeoutMilliseconds) {
+    return socket.wait(timeoutMilliseconds);
+}
@@ -0,0 +1,66 @@
+#ifndef MULTIPLAYER_CLIENT
+#define MULTIPLAYER_CLIENT
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "AircraftStore.h"
+#include "StateSync.h"
+#include "UdpSocket.h"
+
+struct MultiplayerClientStatistics {
+    unsigned long snapshotsReceived = 0;
+    unsigned long bytesReceived = 0;
+    // Snapshots that were malformed, or whose baseline was no longer kept
+    unsigned long snapshotsDiscarded = 0;
+    // Measured in milliseconds, from sending to decoding, per snapshot received
+    std::vector<float> latencies;
+};
+
+// Player of a scene run by a MultiplayerServer, flying one of its aircraft
+// Mirrors the entities around that aircraft, as of the latest snapshot received
+class MultiplayerClient {
+public:
+    // Latest snapshot received, the client's aircraft among the others
+    NetworkSnapshot state;
+
+    // Valid once joined
+    std::uint32_t clientId;
+    AircraftId aircraft;
+    bool joined;
+
+    MultiplayerClientStatistics statistics;
+
+    MultiplayerClient();
+
+    // Binds a free port and asks server to join, see join
+    // returns true on success, false otherwise
+    bool open(const UdpAddress& server);
+
+    // Asks the server to join, called again until joined as datagrams may be lost
+    void join();
+
+    // Steers the client's aircraft, measured as in AircraftStore::steer, and acknowledges the latest snapshot
+    void sendInput(float speed, float climbRate, float turnDegrees);
+
+    // Handles every pending message
+    // returns the number of snapshots received
+    int receive();
+
+    // Blocks until a message is pending or timeoutMilliseconds elapse
+    bool wait(int timeoutMilliseconds);
+
+private:
+    UdpSocket socket;
+    UdpAddress server;
+
+    // Snapshots received, indexed by tick % snapshotHistory, as baselines of the next ones
+    std::array<NetworkSnapshot, snapshotHistory> received;
+
+    // Scratch space: datagram received, message bytes sent
+    std::vector<std::uint8_t> datagram;
+    std::vector<std::uint8_t> buffer;
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include "MultiplayerServer.h"
+
+#include <algorithm>
+
+// Limits on client steering, measured in meters/tick & degrees/tick
+constexpr float maximumClientClimbRate = 5.0f;
+constexpr float maximumClientTurn = 3.0f;
+
+// Bytes of an entity in rawBytes: id & position, plus the heading vector of aircraft
+constexpr std::size_t rawLavaBombSize = sizeof(std::uint32_t) + sizeof(Cartesian3);
+constexpr std::size_t rawAircraftSize = rawLavaBombSize + 2 * sizeof(float);
+
+MultiplayerServer::MultiplayerServer(Scene& scene)
+    : scene(scene),
+      datagram(maximumDatagramSize) {
+}
+
+bool MultiplayerServer::open(const std::uint16_t port) {
+    return socket.open(port);
+}
+
+UdpAddress MultiplayerServer::address() const {
+    return socket.address();
+}
+
+std::size_t MultiplayerServer::clientCount() const {
+    return clients.size();
+}
+
+AircraftId MultiplayerServer::spawnClientAircraft() {
+    scene.spawnAircraft(1);
+    return scene.aircraft.ids.back();
+}
+
+void MultiplayerServer::sendWelcome(const std::size_t client) {
+    buffer.clear();
+    ByteWriter writer(buffer);
+    writer.writeByte(static_cast<std::uint8_t>(MessageType::Welcome));
+    writer.writeVarint(client);
+    writer.writeVarint(clients[client].aircraft);
+    if (!socket.send(clients[client].address, buffer.data(), buffer.size())) {
+        statistics.sendFailures++;
+    }
+}
+
+void MultiplayerServer::receive() {
+    UdpAddress source;
+    long size = 0;
+    while ((size = socket.receive(source, datagram.data(), datagram.size())) >= 0) {
+        ByteReader reader(datagram.data(), static_cast<std::size_t>(size));
+        std::uint8_t type = 0;
+        if (!reader.readByte(type)) {
+            continue;
+        }
+
+        if (type == static_cast<std::uint8_t>(MessageType::Join)) {
+            // Joins are resent until welcomed, so a client may already be known
+            std::size_t client = 0;
+            while (client < clients.size() && !(clients[client].address == source)) {
+                client++;
+            }
+            if (client == clients.size()) {
+                clients.emplace_back();
+                clients.back().address = source;
+                clients.back().aircraft = spawnClientAircraft();
+            }
+            sendWelcome(client);
+            continue;
+        }
+
+        std::uint64_t clientId = 0, acknowledgedTick = 0;
+        std::int64_t speed = 0, climbRate = 0, turn = 0;
+        if (type != static_cast<std::uint8_t>(MessageType::Input) || !reader.readVarint(clientId) ||
+            !reader.readVarint(acknowledgedTick) || !reader.readSigned(speed) || !reader.readSigned(climbRate) ||
+            !reader.readSigned(turn) || clientId >= clients.size() || !(clients[clientId].address == source)) {
+            continue;
+        }
+
+        Client& client = clients[clientId];
+        // Inputs may arrive out of order, acknowledgements only move forward
+        client.acknowledgedTick = std::max<unsigned long>(client.acknowledgedTick, acknowledgedTick);
+
+        const std::size_t aircraft = scene.aircraft.find(client.aircraft);
+        if (aircraft < scene.aircraft.size()) {
+            scene.aircraft.steer(aircraft,
+                                 std::clamp(speed * steeringQuantum, 0.0f, static_cast<float>(maxFlightSpeed)),
+                                 std::clamp(climbRate * steeringQuantum, -maximumClientClimbRate,
+                                            maximumClientClimbRate),
+                                 std::clamp(turn * steeringQuantum, -maximumClientTurn, maximumClientTurn));
+        }
+    }
+}
+
+void MultiplayerServer::selectEntities(const std::vector<EntityState>& world, const std::vector<EntityState>& baseline,
+                                       const Cartesian3& center, std::size_t& budget,
+                                       std::vector<EntityState>& selected) {
+    nearby.clear();
+    for (std::size_t entity = 0; entity < world.size(); entity++) {
+        const Cartesian3 offset = world[entity].position() - center;
+        if (const float distance = offset.dot(offset); distance <= interestRadius * interestRadius) {
+            nearby.emplace_back(distance, entity);
+        }
+    }
+    std::sort(nearby.begin(), nearby.end());
+
+    selected.clear();
+    for (const auto& [distance, entity] : nearby) {
+        const EntityState& state = world[entity];
+        const auto known = std::lower_bound(baseline.begin(), baseline.end(), state.id,
+                                            [](const EntityState& other, const std::uint32_t id) {
+                                                return other.id < id;
+                                            });
+        const bool isKnown = known != baseline.end() && known->id == state.id;
+
+        // Unchanged entities cost nothing, the others count against the budget
+        if (isKnown && *known == state) {
+            selected.push_back(state);
+        } else if (budget > 0) {
+            selected.push_back(state);
+            budget--;
+        } else if (isKnown) {
+            selected.push_back(*known);
+        }
+    }
+
+    std::sort(selected.begin(), selected.end(), [](const EntityState& a, const EntityState& b) {
+        return a.id < b.id;
+    });
+}
+
+void MultiplayerServer::sendSnapshots() {
+    for (std::size_t client = 0; client < clients.size(); client++) {
+        if (scene.aircraft.find(clients[client].aircraft) == scene.aircraft.size()) {
+            clients[client].aircraft = spawnClientAircraft();
+            sendWelcome(client);
+        }
+    }
+
+    scene.captureSnapshot(sceneSnapshot);
+    quantizeSnapshot(sceneSnapshot, world);
+    const std::int64_t sendTime = steadyClockNanoseconds();
+
+    for (Client& client : clients) {
+        const unsigned long tick = world.tick;
+
+        // Baselines must still be kept, and not in the slot about to be overwritten
+        const NetworkSnapshot& acknowledged = client.sent[client.acknowledgedTick % snapshotHistory];
+        const bool hasBaseline = client.acknowledgedTick > 0 && acknowledged.tick == client.acknowledgedTick &&
+                                 tick - client.acknowledgedTick < snapshotHistory;
+        static const NetworkSnapshot empty;
+        const NetworkSnapshot& baseline = hasBaseline ? acknowledged : empty;
+
+        const std::size_t aircraft = scene.aircraft.find(client.aircraft);
+        const Cartesian3 center = scene.aircraft.position(aircraft);
+
+        NetworkSnapshot& snapshot = client.sent[tick % snapshotHistory];
+        snapshot.tick = tick;
+        std::size_t budget = maximumSnapshotUpdates;
+        selectEntities(world.aircraft, baseline.aircraft, center, budget, snapshot.aircraft);
+        selectEntities(world.lavaBombs, baseline.lavaBombs, center, budget, snapshot.lavaBombs);
+
+        buffer.clear();
+        ByteWriter writer(buffer);
+        writeSnapshotMessage(writer, snapshot, hasBaseline ? &baseline : nullptr, sendTime);
+        if (!socket.send(client.address, buffer.data(), buffer.size())) {
+            statistics.sendFailures++;
+        }
+
+        statistics.snapshotsSent++;
+        statistics.fullSnapshotsSent += !hasBaseline;
+        statistics.bytesSent += buffer.size();
+        statistics.rawBytes += world.aircraft.size() * rawAircraftSize + world.lavaBombs.size() * rawLavaBombSize;
+        statistics.entitiesSent += snapshot.aircraft.size() + snapshot.lavaBombs.size();
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef MULTIPLAYER_SERVER
+#define MULTIPLAYER_SERVER
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "AircraftStore.h"
+#include "Scene.h"
+#include "SceneSnapshot.h"
+#include "StateSync.h"
+#include "UdpSocket.h"
+
+// Measured in meters, clients are sent the entities this close to their aircraft
+constexpr float interestRadius = 10000.0f;
+
+// Most entities sent per snapshot, nearest first, so that snapshots fit a datagram of a typical MTU
+// Farther entities keep the state the client last received, until their turn comes
+constexpr std::size_t maximumSnapshotUpdates = 96;
+
+struct MultiplayerServerStatistics {
+    unsigned long snapshotsSent = 0;
+    // Sent in full, as the client had acknowledged none of the snapshots kept
+    unsigned long fullSnapshotsSent = 0;
+    unsigned long bytesSent = 0;
+    // Bytes the same snapshots would take with the id, float position & heading of every entity of the world
+    unsigned long rawBytes = 0;
+    // Entities around the clients, summed over the snapshots sent
+    unsigned long entitiesSent = 0;
+    // Datagrams the socket did not take, e.g. as its buffer was full
+    unsigned long sendFailures = 0;
+};
+
+// Authoritative server of a Scene shared by players over UDP, see StateSync for the messages
+// Each client flies one of the scene's aircraft, steered by its inputs, and is sent the aircraft & lava bombs around it
+// after every tick, quantized and delta compressed against the latest snapshot it acknowledged
+// The owner runs the scene, calling receive, Scene::update then sendSnapshots on a single thread
+class MultiplayerServer {
+public:
+    MultiplayerServerStatistics statistics;
+
+    explicit MultiplayerServer(Scene& scene);
+
+    // Listens on 127.0.0.1:port, any free port if 0
+    // returns true on success, false otherwise
+    bool open(std::uint16_t port = 0);
+
+    UdpAddress address() const;
+
+    std::size_t clientCount() const;
+
+    // Handles every pending message, joins add an aircraft for their client, inputs steer it
+    void receive();
+
+    // Sends each client a snapshot of the scene's latest tick, clients whose aircraft crashed get a new one first
+    void sendSnapshots();
+
+private:
+    struct Client {
+        UdpAddress address;
+        AircraftId aircraft = 0;
+        // Latest tick the client received a snapshot of, 0 for none
+        unsigned long acknowledgedTick = 0;
+        // Snapshots as sent, indexed by tick % snapshotHistory
+        std::array<NetworkSnapshot, snapshotHistory> sent;
+    };
+
+    Scene& scene;
+    UdpSocket socket;
+    std::vector<Client> clients;
+
+    // The scene's latest tick, as captured and quantized
+    SceneSnapshot sceneSnapshot;
+    NetworkSnapshot world;
+
+    // Scratch space: datagram received, message bytes sent, entities near a client by squared distance
+    std::vector<std::uint8_t> datagram;
+    std::vector<std::uint8_t> buffer;
+    std::vector<std::pair<float, std::size_t>> nearby;
+
+    AircraftId spawnClientAircraft();
+
+    void sendWelcome(std::size_t client);
+
+    // Fills selected with the entities of world near center, or the baseline's state of those left out of budget
+    void selectEntities(const std::vector<EntityState>& world, const std::vector<EntityState>& baseline,
+                        const Cartesian3& center, std::size_t& budget, std::vector<EntityState>& selected);
+};
+
+#endif
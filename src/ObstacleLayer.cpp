@@ -0,0 +1,128 @@
+#include "ObstacleLayer.h"
+
+#include <string>
+#include <string_view>
+
+#include "TextScanner.h"
+#include "TraceEvents.h"
+
+bool ObstacleLayer::readObstacleFile(const char* fileName) {
+    TRACE_SCOPE("load", "readObstacleFile");
+
+    std::string contents;
+    if (!readWholeFile(fileName, contents)) {
+        return false;
+    }
+    TextScanner scanner(contents);
+
+    // A model name followed by its position, per obstacle
+    std::string_view modelName;
+    while (scanner.readToken(modelName)) {
+        Cartesian3 position;
+        if (!scanner.read(position.x) || !scanner.read(position.y) || !scanner.read(position.z)) {
+            return false;
+        }
+
+        const int model = addModel(std::string(modelName).data());
+        if (model < 0) {
+            return false;
+        }
+
+        addObstacle(model, position);
+    }
+
+    build();
+
+    return true;
+}
+
+int ObstacleLayer::addModel(const char* fileName) {
+    for (size_t model = 0; model < modelNames.size(); model++) {
+        if (modelNames[model] == fileName) {
+            return static_cast<int>(model);
+        }
+    }
+
+    HomogeneousFaceSurface model;
+    if (!model.readTriangleSoupFile(fileName)) {
+        return -1;
+    }
+
+    AxisAlignedBox bounds;
+    for (const auto& vertex : model.convexHull.vertices) {
+        bounds.grow(vertex);
+    }
+
+    models.push_back(std::move(model));
+    modelNames.emplace_back(fileName);
+    modelBounds.push_back(bounds);
+
+    return static_cast<int>(models.size() - 1);
+}
+
+void ObstacleLayer::addObstacle(const std::uint32_t model, const Cartesian3& position) {
+    obstacles.push_back({model, position});
+}
+
+void ObstacleLayer::build() {
+    TRACE_SCOPE("load", "buildObstacleHierarchy");
+
+    std::vector<AxisAlignedBox> obstacleBounds;
+    obstacleBounds.reserve(obstacles.size());
+
+    for (const auto& obstacle : obstacles) {
+        const AxisAlignedBox& bounds = modelBounds[obstacle.model];
+        obstacleBounds.emplace_back(bounds.minimum + obstacle.position, bounds.maximum + obstacle.position);
+    }
+
+    hierarchy.build(obstacleBounds);
+}
+
+bool ObstacleLayer::empty() const {
+    return obstacles.empty();
+}
+
+AxisAlignedBox ObstacleLayer::bounds() const {
+    return hierarchy.nodes.empty() ? AxisAlignedBox() : hierarchy.nodes[0].bounds;
+}
+
+bool ObstacleLayer::isCollision(const PlacedConvexHull& shape,
+                                const Cartesian3& boundingCenter,
+                                const float boundingRadius) const {
+    return hierarchy.anySphereOverlap(boundingCenter, boundingRadius, [&](const std::uint32_t obstacleIndex) {
+        const Obstacle& obstacle = obstacles[obstacleIndex];
+
+        PlacedConvexHull placedObstacle;
+        placedObstacle.hull = &models[obstacle.model].convexHull;
+        placedObstacle.position = obstacle.position;
+
+        return isConvexHullCollision(shape, placedObstacle);
+    });
+}
+
+bool ObstacleLayer::isSphereCollision(const Cartesian3& center, const float radius) const {
+    PlacedConvexHull sphere;
+    sphere.position = center;
+    sphere.margin = radius;
+
+    return isCollision(sphere, center, radius);
+}
+
+void ObstacleLayer::render(const Matrix4& viewMatrix) const {
+    for (const auto& obstacle : obstacles) {
+        models[obstacle.model].render(viewMatrix * Matrix4::translation(obstacle.position));
+    }
+}
+
+MemoryReport ObstacleLayer::memoryReport() const {
+    MemoryReport report;
+    report.add("models", models);
+    for (std::size_t model = 0; model < models.size(); model++) {
+        report.add("models[" + std::to_string(model) + "].", models[model].memoryReport());
+    }
+    report.add("modelBounds", modelBounds);
+    report.add("obstacles", obstacles);
+    report.add("hierarchy.nodes", hierarchy.nodes);
+    report.add("hierarchy.itemIndices", hierarchy.itemIndices);
+    return report;
+}
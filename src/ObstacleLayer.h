@@ -0,0 +1,64 @@
+#ifndef OBSTACLE_LAYER
+#define OBSTACLE_LAYER
+
+#include <string>
+#include <vector>
+
+#include "BoundingVolumeHierarchy.h"
+#include "Cartesian3.h"
+#include "ConvexCollision.h"
+#include "HomogeneousFaceSurface.h"
+#include "Matrix4.h"
+#include "MemoryReport.h"
+
+// Static obstacle, i.e. one of the models of an ObstacleLayer placed in the world
+struct Obstacle {
+    std::uint32_t model;
+    Cartesian3 position;
+};
+
+// Static obstacles indexed by a BVH over their world bounds, so queries don't scale with their number
+class ObstacleLayer {
+public:
+    // Models shared by the obstacles, each loaded once
+    std::vector<HomogeneousFaceSurface> models;
+    std::vector<std::string> modelNames;
+
+    std::vector<Obstacle> obstacles;
+
+    BoundingVolumeHierarchy hierarchy;
+
+    // reads .obs obstacle placement file, one "<model .tri file> x y z" line per obstacle
+    // returns true on success, false otherwise
+    bool readObstacleFile(const char* fileName);
+
+    // loads the .tri model unless already loaded, returns its index or -1 if it couldn't be read
+    int addModel(const char* fileName);
+
+    void addObstacle(std::uint32_t model, const Cartesian3& position);
+
+    // Must be called after adding obstacles, before querying
+    void build();
+
+    bool empty() const;
+
+    // Bounds of every obstacle, an empty box if there are none
+    AxisAlignedBox bounds() const;
+
+    // Whether any obstacle collides with shape, which must fit the sphere = {boundingCenter, boundingRadius}
+    bool isCollision(const PlacedConvexHull& shape, const Cartesian3& boundingCenter, float boundingRadius) const;
+
+    // Whether any obstacle collides with the sphere = {center, radius}
+    bool isSphereCollision(const Cartesian3& center, float radius) const;
+
+    // viewMatrix must map world coordinates, each obstacle is translated to its position on top
+    void render(const Matrix4& viewMatrix) const;
+
+    // Footprint of the obstacles, their models & hierarchy, model names excluded
+    MemoryReport memoryReport() const;
+
+private:
+    std::vector<AxisAlignedBox> modelBounds;
+};
+
+#endif
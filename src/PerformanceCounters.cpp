@@ -0,0 +1,165 @@
+#include "PerformanceCounters.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "AllocationCounter.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+CounterValues& CounterValues::operator +=(const CounterValues& other) {
+    for (std::size_t counter = 0; counter < hardwareCounterCount; counter++) {
+        counts[counter] += other.counts[counter];
+    }
+    wallTime += other.wallTime;
+    allocations += other.allocations;
+    allocatedBytes += other.allocatedBytes;
+    return *this;
+}
+
+CounterValues operator -(const CounterValues& end, const CounterValues& start) {
+    CounterValues difference;
+    for (std::size_t counter = 0; counter < hardwareCounterCount; counter++) {
+        difference.counts[counter] = end.counts[counter] - start.counts[counter];
+    }
+    difference.wallTime = end.wallTime - start.wallTime;
+    difference.allocations = end.allocations - start.allocations;
+    difference.allocatedBytes = end.allocatedBytes - start.allocatedBytes;
+    return difference;
+}
+
+PerformanceCounters::PerformanceCounters()
+    : nOpen(0),
+      leader(-1) {
+    descriptors.fill(-1);
+    groupPositions.fill(0);
+}
+
+PerformanceCounters::~PerformanceCounters() {
+#ifdef __linux__
+    for (const int descriptor : descriptors) {
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+    }
+#endif
+}
+
+#ifdef __linux__
+perf_event_attr counterAttributes(const HardwareCounter counter) {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.read_format = PERF_FORMAT_GROUP;
+    // Counting user space only is allowed up to perf_event_paranoid 2, the default on most distributions
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    switch (counter) {
+        case HardwareCounter::Cycles:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case HardwareCounter::Instructions:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case HardwareCounter::L1DataMisses:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case HardwareCounter::LastLevelCacheMisses:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case HardwareCounter::BranchMisses:
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+    }
+    return attributes;
+}
+#endif
+
+bool PerformanceCounters::open() {
+#ifdef __linux__
+    for (std::size_t counter = 0; counter < hardwareCounterCount; counter++) {
+        perf_event_attr attributes = counterAttributes(static_cast<HardwareCounter>(counter));
+        // The group starts disabled and is enabled at once, so that its counters cover the same instructions
+        attributes.disabled = leader < 0 ? 1 : 0;
+
+        // Calling thread, any CPU
+        const int descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0));
+        if (descriptor < 0) {
+            if (reason.empty()) {
+                reason = std::string(hardwareCounterNames[counter]) + ": perf_event_open failed, " +
+                         std::strerror(errno);
+                if (errno == EACCES || errno == EPERM) {
+                    reason += ", see /proc/sys/kernel/perf_event_paranoid";
+                }
+            }
+            continue;
+        }
+
+        if (leader < 0) {
+            leader = descriptor;
+        }
+        descriptors[counter] = descriptor;
+        groupPositions[counter] = nOpen++;
+    }
+
+    if (leader >= 0) {
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    return leader >= 0;
+#else
+    reason = "hardware counters need perf_event_open, which only Linux provides";
+    return false;
+#endif
+}
+
+bool PerformanceCounters::isAvailable(const HardwareCounter counter) const {
+    return descriptors[static_cast<std::size_t>(counter)] >= 0;
+}
+
+bool PerformanceCounters::anyAvailable() const {
+    return leader >= 0;
+}
+
+const std::string& PerformanceCounters::unavailableReason() const {
+    return reason;
+}
+
+CounterValues PerformanceCounters::read() const {
+    CounterValues values;
+    values.wallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+
+    const AllocationCount allocationCount = threadAllocationCount();
+    values.allocations = allocationCount.allocations;
+    values.allocatedBytes = allocationCount.bytes;
+
+#ifdef __linux__
+    if (leader >= 0) {
+        // PERF_FORMAT_GROUP layout: number of counters, then their values in opening order
+        std::uint64_t group[1 + hardwareCounterCount];
+        if (::read(leader, group, sizeof(group)) > 0) {
+            for (std::size_t counter = 0; counter < hardwareCounterCount; counter++) {
+                if (descriptors[counter] >= 0) {
+                    values.counts[counter] = group[1 + groupPositions[counter]];
+                }
+            }
+        }
+    }
+#endif
+
+    return values;
+}
@@ -0,0 +1,119 @@
+#ifndef PERFORMANCE_COUNTERS
+#define PERFORMANCE_COUNTERS
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Hardware events counted through perf_event_open, on Linux only
+enum class HardwareCounter {
+    Cycles,
+    Instructions,
+    L1DataMisses,
+    LastLevelCacheMisses,
+    BranchMisses
+};
+
+constexpr std::size_t hardwareCounterCount = 5;
+
+const std::array<const char*, hardwareCounterCount> hardwareCounterNames = {
+    "cycles",
+    "instructions",
+    "L1d misses",
+    "LLC misses",
+    "branch misses"
+};
+
+// Counter values, plus wall time in nanoseconds, which is always available
+// and heap allocations, which are counted with ENABLE_ALLOCATION_COUNTING only, see AllocationCounter.h
+struct CounterValues {
+    std::array<std::uint64_t, hardwareCounterCount> counts{};
+    std::int64_t wallTime = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t allocatedBytes = 0;
+
+    CounterValues& operator +=(const CounterValues& other);
+};
+
+CounterValues operator -(const CounterValues& end, const CounterValues& start);
+
+// The calling thread's hardware counters, read as a single group so that their values are consistent
+// Counters that cannot be opened, e.g. due to perf_event_paranoid or virtualization, read as 0
+class PerformanceCounters {
+public:
+    PerformanceCounters();
+
+    // Closes the counters
+    ~PerformanceCounters();
+
+    PerformanceCounters(const PerformanceCounters&) = delete;
+
+    PerformanceCounters& operator =(const PerformanceCounters&) = delete;
+
+    // Opens and starts the counters for the calling thread, which must be the one calling read
+    // returns true if any counter could be opened, false if only wall time is available
+    bool open();
+
+    bool isAvailable(HardwareCounter counter) const;
+
+    bool anyAvailable() const;
+
+    // Why counters are missing, empty if all of them are available
+    const std::string& unavailableReason() const;
+
+    CounterValues read() const;
+
+private:
+    // File descriptor per counter, the first one opened leads the group, -1 if unavailable
+    std::array<int, hardwareCounterCount> descriptors;
+    // Position of each available counter within a group read
+    std::array<std::size_t, hardwareCounterCount> groupPositions;
+    std::size_t nOpen;
+    int leader;
+    std::string reason;
+};
+
+// Counter totals of a fixed set of phases, indexed by an enum class of PhaseCount values
+template <std::size_t PhaseCount>
+class PhaseCounters {
+public:
+    PerformanceCounters counters;
+    std::array<CounterValues, PhaseCount> totals{};
+    std::array<unsigned long, PhaseCount> samples{};
+};
+
+// Adds the counter deltas between its construction and destruction to phase, does nothing if phaseCounters is null
+template <typename Counters, typename Phase>
+class ScopedPhaseCounters {
+public:
+    ScopedPhaseCounters(Counters* phaseCounters, const Phase phase)
+        : phaseCounters(phaseCounters),
+          phase(phase) {
+        if (phaseCounters) {
+            start = phaseCounters->counters.read();
+        }
+    }
+
+    ~ScopedPhaseCounters() {
+        if (phaseCounters) {
+            const auto index = static_cast<std::size_t>(phase);
+            phaseCounters->totals[index] += phaseCounters->counters.read() - start;
+            phaseCounters->samples[index]++;
+        }
+    }
+
+    ScopedPhaseCounters(const ScopedPhaseCounters&) = delete;
+
+    ScopedPhaseCounters& operator =(const ScopedPhaseCounters&) = delete;
+
+private:
+    Counters* phaseCounters;
+    const Phase phase;
+    CounterValues start;
+};
+
+#define COUNT_PHASE(phaseCounters, phase) ScopedPhaseCounters phaseCounterScope(phaseCounters, phase)
+
+#endif
@@ -0,0 +1,34 @@
+#include "PhaseTimer.h"
+
+#include <algorithm>
+
+PhaseSummary summarizePhaseSamples(const float* samples, const std::size_t count) {
+    PhaseSummary summary;
+    if (count == 0) {
+        return summary;
+    }
+
+    // Copied so that partitioning for the percentile leaves the ring buffer's order intact
+    std::array<float, phaseTimingWindow> sorted;
+    std::copy(samples, samples + count, sorted.begin());
+
+    float sum = 0.0f;
+    for (std::size_t i = 0; i < count; i++) {
+        sum += sorted[i];
+    }
+    summary.average = sum / static_cast<float>(count);
+    summary.minimum = *std::min_element(sorted.begin(), sorted.begin() + count);
+
+    // Nearest-rank percentile
+    const std::size_t p99Rank = (99 * count + 99) / 100 - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + p99Rank, sorted.begin() + count);
+    summary.p99 = sorted[p99Rank];
+
+    return summary;
+}
+
+#ifdef ENABLE_PHASE_TIMING
+void writePhaseCsvHeader(std::ostream& outStream) {
+    outStream << "group,phase,samples,min_ms,avg_ms,p99_ms,overall_avg_ms\n";
+}
+#endif
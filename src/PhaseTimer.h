@@ -0,0 +1,143 @@
+#ifndef PHASE_TIMER
+#define PHASE_TIMER
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+// Built with ENABLE_PHASE_TIMING defined, TIME_PHASE scopes are timed
+// Built without it they expand to nothing, and PhaseTimings hold and record nothing, see below
+#ifdef ENABLE_PHASE_TIMING
+constexpr bool phaseTimingEnabled = true;
+#define TIME_PHASE(timings, phase) ScopedPhaseTimer phaseTimer(timings, phase)
+#else
+constexpr bool phaseTimingEnabled = false;
+#define TIME_PHASE(timings, phase)
+#endif
+
+// Latest samples kept per phase, the rolling statistics cover these
+constexpr std::size_t phaseTimingWindow = 256;
+
+// Rolling statistics of a phase, measured in milliseconds
+struct PhaseSummary {
+    float minimum = 0.0f;
+    float average = 0.0f;
+    float p99 = 0.0f;
+};
+
+// samples holds count durations in no particular order, count must not exceed phaseTimingWindow
+PhaseSummary summarizePhaseSamples(const float* samples, std::size_t count);
+
+// Durations of a fixed set of phases, indexed by an enum class of PhaseCount values
+// Written by one thread only, reading concurrently is left to the owner to avoid
+// Kept regardless of ENABLE_PHASE_TIMING, for measurements that are not per-phase timing, e.g. input latency
+template <std::size_t PhaseCount>
+class DurationSamples {
+public:
+    // duration is measured in milliseconds
+    void record(const std::size_t phase, const float duration) {
+        samples[phase][nRecorded[phase] % phaseTimingWindow] = duration;
+        nRecorded[phase]++;
+        totals[phase] += duration;
+    }
+
+    // Over the latest phaseTimingWindow durations of phase
+    PhaseSummary summarize(const std::size_t phase) const {
+        return summarizePhaseSamples(samples[phase].data(), std::min<std::size_t>(nRecorded[phase], phaseTimingWindow));
+    }
+
+    // Measured in milliseconds, most recent duration of phase, or 0 if none was recorded
+    float latest(const std::size_t phase) const {
+        return nRecorded[phase] > 0 ? samples[phase][(nRecorded[phase] - 1) % phaseTimingWindow] : 0.0f;
+    }
+
+    // Number of durations recorded for phase so far
+    unsigned long recorded(const std::size_t phase) const {
+        return nRecorded[phase];
+    }
+
+    // Measured in milliseconds, sum of all durations recorded for phase so far
+    double total(const std::size_t phase) const {
+        return totals[phase];
+    }
+
+private:
+    // Ring buffers, the oldest sample is overwritten once full
+    std::array<std::array<float, phaseTimingWindow>, PhaseCount> samples{};
+    std::array<unsigned long, PhaseCount> nRecorded{};
+    std::array<double, PhaseCount> totals{};
+};
+
+#ifdef ENABLE_PHASE_TIMING
+template <std::size_t PhaseCount>
+using PhaseTimings = DurationSamples<PhaseCount>;
+
+// Records the time between its construction and destruction as one duration of phase
+template <typename Timings, typename Phase>
+class ScopedPhaseTimer {
+public:
+    ScopedPhaseTimer(Timings& timings, const Phase phase)
+        : timings(timings),
+          phase(phase),
+          start(std::chrono::steady_clock::now()) {
+    }
+
+    ~ScopedPhaseTimer() {
+        const auto duration = std::chrono::steady_clock::now() - start;
+        timings.record(static_cast<std::size_t>(phase), std::chrono::duration<float, std::milli>(duration).count());
+    }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+
+    ScopedPhaseTimer& operator =(const ScopedPhaseTimer&) = delete;
+
+private:
+    Timings& timings;
+    const Phase phase;
+    const std::chrono::steady_clock::time_point start;
+};
+
+// Header line of writePhaseCsvRows
+void writePhaseCsvHeader(std::ostream& outStream);
+
+// One row per phase: group, phase name, samples, rolling min/avg/p99 and overall average, in milliseconds
+template <std::size_t PhaseCount>
+void writePhaseCsvRows(std::ostream& outStream, const char* group, const PhaseTimings<PhaseCount>& timings,
+                       const std::array<const char*, PhaseCount>& phaseNames) {
+    for (std::size_t phase = 0; phase < PhaseCount; phase++) {
+        const PhaseSummary summary = timings.summarize(phase);
+        const unsigned long recorded = timings.recorded(phase);
+        outStream << group << ',' << phaseNames[phase] << ',' << recorded << ','
+                  << summary.minimum << ',' << summary.average << ',' << summary.p99 << ','
+                  << (recorded > 0 ? timings.total(phase) / recorded : 0.0) << '\n';
+    }
+}
+#else
+// Stands in for DurationSamples, holding no samples, so that code reading phase timings compiles unchanged
+template <std::size_t PhaseCount>
+class PhaseTimings {
+public:
+    void record(std::size_t, float) {
+    }
+
+    PhaseSummary summarize(std::size_t) const {
+        return PhaseSummary();
+    }
+
+    float latest(std::size_t) const {
+        return 0.0f;
+    }
+
+    unsigned long recorded(std::size_t) const {
+        return 0;
+    }
+
+    double total(std::size_t) const {
+        return 0.0;
+    }
+};
+#endif
+
+#endif
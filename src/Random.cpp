@@ -1,50 +1,81 @@
 #include "Random.h"
 
+#include <algorithm>
 #include <cmath>
 
-float randomRange(const float minimum, const float maximum) {
-    // Create random number in [minimum, maximum]
-    float randomNumber = static_cast<float>(random()) / static_cast<float>(RAND_MAX);
-    const float range = maximum - minimum;
-    randomNumber *= range;
-    return randomNumber + minimum;
+constexpr float twoPi = 6.28318530717958647692f;
+
+// Spreads seeds that differ in few bits over the whole state, as recommended for xoshiro
+std::uint64_t splitMix64(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
 }
 
-Cartesian3 randomVector(const float minimum, const float maximum) {
-    return {
-        randomRange(minimum, maximum),
-        randomRange(minimum, maximum),
-        randomRange(minimum, maximum)
-    };
+std::uint32_t rotateLeft(const std::uint32_t x, const int k) {
+    return (x << k) | (x >> (32 - k));
 }
 
-Cartesian3 randomUnitVectorInUpwardsCone(const float minimumAngle,
-                                         const float minimumLength,
-                                         const float maximumLength) {
-    // use the minimum vertical angle to compute a cosine *downward* from azimuth
-    // i.e. use the sine instead
-    const float minimumCosineValue = std::sin(minimumAngle);
+Random::Random(const std::uint32_t seed) {
+    this->seed(seed);
+}
+
+void Random::seed(const std::uint32_t seed) {
+    std::uint64_t x = seed;
+    const std::uint64_t low = splitMix64(x);
+    const std::uint64_t high = splitMix64(x);
 
-    // loop until good vector
-    while (true) {
-        // random vector in a box
-        Cartesian3 result = randomVector(-maximumLength, maximumLength);
+    // Never all zeroes, splitMix64 maps distinct inputs to distinct outputs
+    state[0] = static_cast<std::uint32_t>(low);
+    state[1] = static_cast<std::uint32_t>(low >> 32);
+    state[2] = static_cast<std::uint32_t>(high);
+    state[3] = static_cast<std::uint32_t>(high >> 32);
+}
+
+std::uint32_t Random::next() {
+    const std::uint32_t result = state[0] + state[3];
+    const std::uint32_t t = state[1] << 9;
 
-        float resultLength = result.length();
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotateLeft(state[3], 11);
+
+    return result;
+}
 
-        // discard vectors with bad lengths
-        if (resultLength < minimumLength) {
-            continue;
-        }
+float Random::unit() {
+    // The upper bits are the better ones in xoshiro128+, 24 of them fill a float's mantissa exactly
+    return static_cast<float>(next() >> 8) * 0x1.0p-24f;
+}
+
+float Random::range(const float minimum, const float maximum) {
+    return minimum + (maximum - minimum) * unit();
+}
+
+Cartesian3 Random::vector(const float minimum, const float maximum) {
+    const float x = range(minimum, maximum);
+    const float y = range(minimum, maximum);
+    const float z = range(minimum, maximum);
+    return {x, y, z};
+}
+
+void Random::upwardsConeVelocities(Cartesian3* velocities, const std::size_t count, const float minimumAngle,
+                                   const float minimumSpeed, const float maximumSpeed) {
+    const float minimumCosineValue = std::sin(minimumAngle);
+    const float heightRange = 1.0f - minimumCosineValue;
+    const float speedRange = maximumSpeed - minimumSpeed;
 
-        if (resultLength > maximumLength) {
-            continue;
-        }
+    for (std::size_t i = 0; i < count; i++) {
+        const float speed = minimumSpeed + speedRange * unit();
+        // A spherical cap's area grows linearly with its height, so a uniform height gives a uniform direction
+        const float z = minimumCosineValue + heightRange * unit();
+        const float azimuth = twoPi * unit();
+        const float horizontalSpeed = speed * std::sqrt(std::max(0.0f, 1.0f - z * z));
 
-        // take dot product and compare with minimum angle
-        // if it's a satisfactory angle, return immediately
-        if (result.dot(Cartesian3(0.0, 0.0, 1.0)) > minimumCosineValue * resultLength) {
-            return result;
-        }
+        velocities[i] = Cartesian3(horizontalSpeed * std::cos(azimuth), horizontalSpeed * std::sin(azimuth), speed * z);
     }
 }
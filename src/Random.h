@@ -1,13 +1,37 @@
 #ifndef RANDOM_H
 #define RANDOM_H
 
+#include <cstddef>
+#include <cstdint>
+
 #include "Cartesian3.h"
 
-float randomRange(float minimum, float maximum);
+// xoshiro128+ generator, small and fast enough to give every Scene or worker its own
+// Generators seeded alike draw the same numbers, regardless of what other generators do
+class Random {
+public:
+    explicit Random(std::uint32_t seed = 0);
+
+    void seed(std::uint32_t seed);
+
+    std::uint32_t next();
+
+    // in [0, 1)
+    float unit();
+
+    // in [minimum, maximum)
+    float range(float minimum, float maximum);
+
+    Cartesian3 vector(float minimum, float maximum);
 
-Cartesian3 randomVector(float minimum, float maximum);
+    // Fills velocities with count vectors, each with a speed in [minimumSpeed, maximumSpeed) and a direction
+    // uniformly distributed over those whose vertical component is at least sin(minimumAngle)
+    // Directions are sampled directly by inverting the cumulative distribution of the cone's solid angle
+    void upwardsConeVelocities(Cartesian3* velocities, std::size_t count, float minimumAngle,
+                               float minimumSpeed, float maximumSpeed);
 
-// generates a random vector with Monte Carlo simulation
-Cartesian3 randomUnitVectorInUpwardsCone(float minimumAngle, float minimumLength, float maximumLength);
+private:
+    std::uint32_t state[4];
+};
 
 #endif
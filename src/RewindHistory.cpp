@@ -0,0 +1,120 @@
+#include "RewindHistory.h"
+
+#include <chrono>
+#include <utility>
+
+#include "SceneState.h"
+
+typedef std::chrono::steady_clock Clock;
+
+RewindHistory::RewindHistory(const unsigned long interval, const unsigned long span)
+    : interval(interval > 0 ? interval : 1),
+      capacity((span + this->interval - 1) / this->interval + rewindKeyframeInterval),
+      sinceKeyframe(0) {
+}
+
+void RewindHistory::capture(const Scene& scene) {
+    if (scene.ticks % interval != 0 || (!snapshots.empty() && snapshots.back().tick >= scene.ticks)) {
+        return;
+    }
+
+    const Clock::time_point captureStart = Clock::now();
+    scene.saveState(state);
+
+    RewindSnapshot snapshot;
+    snapshot.tick = scene.ticks;
+    if (!spareBuffers.empty()) {
+        snapshot.bytes.swap(spareBuffers.back());
+        spareBuffers.pop_back();
+    } else {
+        // Room for a whole state upfront, rather than growing along with the delta until the history is full
+        snapshot.bytes.reserve(state.size());
+    }
+
+    snapshot.keyframe = snapshots.empty() || sinceKeyframe >= rewindKeyframeInterval;
+    if (snapshot.keyframe) {
+        snapshot.bytes.assign(state.begin(), state.end());
+        sinceKeyframe = 1;
+    } else {
+        encodeStateDelta(newestState, state, snapshot.bytes);
+        sinceKeyframe++;
+    }
+    newestState.swap(state);
+
+    statistics.captures++;
+    statistics.stateBytes += newestState.size();
+    statistics.storedBytes += snapshot.bytes.size();
+    snapshots.push_back(std::move(snapshot));
+
+    // Deltas are useless without the keyframe before them, so they go along with it
+    if (snapshots.size() > capacity) {
+        do {
+            drop(snapshots.front());
+            snapshots.pop_front();
+        } while (!snapshots.empty() && !snapshots.front().keyframe);
+    }
+
+    statistics.captureTime += std::chrono::duration<double>(Clock::now() - captureStart).count();
+}
+
+bool RewindHistory::rewind(const unsigned long tick, Scene& scene) {
+    std::size_t latest = snapshots.size();
+    while (latest > 0 && snapshots[latest - 1].tick > tick) {
+        latest--;
+    }
+    if (latest == 0) {
+        return false;
+    }
+    latest--;
+
+    std::size_t keyframe = latest;
+    while (!snapshots[keyframe].keyframe) {
+        keyframe--;
+    }
+
+    state = snapshots[keyframe].bytes;
+    std::vector<std::uint8_t> decoded;
+    for (std::size_t i = keyframe + 1; i <= latest; i++) {
+        if (!decodeStateDelta(state, snapshots[i].bytes, decoded)) {
+            return false;
+        }
+        state.swap(decoded);
+    }
+
+    if (!scene.restoreState(state)) {
+        return false;
+    }
+
+    while (snapshots.size() > latest + 1) {
+        drop(snapshots.back());
+        snapshots.pop_back();
+    }
+    newestState.swap(state);
+    sinceKeyframe = latest - keyframe + 1;
+    return true;
+}
+
+bool RewindHistory::empty() const {
+    return snapshots.empty();
+}
+
+unsigned long RewindHistory::oldestTick() const {
+    return snapshots.front().tick;
+}
+
+unsigned long RewindHistory::newestTick() const {
+    return snapshots.back().tick;
+}
+
+std::size_t RewindHistory::storedSize() const {
+    std::size_t size = 0;
+    for (const auto& snapshot : snapshots) {
+        size += snapshot.bytes.size();
+    }
+    return size;
+}
+
+void RewindHistory::drop(RewindSnapshot& snapshot) {
+    snapshot.bytes.clear();
+    spareBuffers.push_back(std::move(snapshot.bytes));
+}
@@ -0,0 +1,82 @@
+#ifndef REWIND_HISTORY
+#define REWIND_HISTORY
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "Scene.h"
+
+// Ticks between two snapshots, half a second at 60 Hz
+constexpr unsigned long defaultRewindInterval = 30;
+
+// Ticks the snapshots kept cover at least, a minute at 60 Hz
+constexpr unsigned long defaultRewindSpan = 3600;
+
+// Snapshots from one full state to the next, the others are deltas from the snapshot before them
+// Restoring a snapshot decodes at most rewindKeyframeInterval - 1 deltas
+constexpr std::size_t rewindKeyframeInterval = 16;
+
+struct RewindSnapshot {
+    unsigned long tick = 0;
+    bool keyframe = false;
+    // State saved by Scene::saveState if keyframe, see encodeStateDelta otherwise
+    std::vector<std::uint8_t> bytes;
+};
+
+struct RewindHistoryStatistics {
+    unsigned long captures = 0;
+    // Measured in seconds, spent saving and encoding snapshots
+    double captureTime = 0.0;
+    // Bytes of the states saved, and of the snapshots kept for them
+    unsigned long stateBytes = 0;
+    unsigned long storedBytes = 0;
+};
+
+// Snapshots of a Scene taken every interval ticks over its latest span ticks, to rewind it to any of them
+// Consecutive states mostly differ in positions, so most snapshots only hold the bytes that changed
+class RewindHistory {
+public:
+    RewindHistoryStatistics statistics;
+
+    explicit RewindHistory(unsigned long interval = defaultRewindInterval, unsigned long span = defaultRewindSpan);
+
+    // Takes a snapshot of scene if its tick is a multiple of interval, called after every update
+    void capture(const Scene& scene);
+
+    // Restores the latest snapshot taken at or before tick, and drops the snapshots taken after it
+    // returns true on success, false if there is none
+    bool rewind(unsigned long tick, Scene& scene);
+
+    bool empty() const;
+
+    // Ticks of the oldest & newest snapshots kept, the history must not be empty
+    unsigned long oldestTick() const;
+
+    unsigned long newestTick() const;
+
+    // Bytes held by the snapshots kept
+    std::size_t storedSize() const;
+
+private:
+    const unsigned long interval;
+    // Most snapshots kept, a whole run from one keyframe to the next is dropped at once
+    const std::size_t capacity;
+
+    std::deque<RewindSnapshot> snapshots;
+    // Storage of dropped snapshots, reused by the next ones
+    std::vector<std::vector<std::uint8_t>> spareBuffers;
+
+    // State of the newest snapshot, deltas are encoded from it
+    std::vector<std::uint8_t> newestState;
+    // Scratch space for the state being saved or decoded
+    std::vector<std::uint8_t> state;
+
+    // Snapshots since the newest keyframe, itself included
+    std::size_t sinceKeyframe;
+
+    void drop(RewindSnapshot& snapshot);
+};
+
+#endif
@@ -1,11 +1,21 @@
 #include "Scene.h"
 
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <utility>
 
+#include "ConvexCollision.h"
 #include "LavaBombParticle.h"
 #include "Matrix4.h"
 #include "Random.h"
+#include "SceneState.h"
 #include "SphereCollision.h"
+#include "TelemetryRing.h"
+#include "TraceEvents.h"
 
 #ifdef __APPLE__
 #include <OpenGL/gl.h>
@@ -15,11 +25,6 @@
 #include <GL/glu.h>
 #endif
 
-// three local variables with the hardcoded file names
-const std::string terrainName = "assets/landscape.dem";
-const std::string planeModelName = "assets/planeModel.tri";
-const std::string lavaBombModelName = "assets/lavaBombModel.tri";
-
 const Homogeneous4 sunDirection(0.0, 0.3, 0.3, 1.0);
 constexpr std::array<float, 4> groundColour = {0.2, 0.6, 0.2, 1.0};
 constexpr std::array<float, 4> sunAmbient = {0.1, 0.1, 0.1, 1.0};
@@ -32,23 +37,64 @@ const Cartesian3 chaseCamVector(0.0, -2.0, 0.5);
 const Cartesian3 worldOrigin(0.0f, 0.0f, 0.0f);
 const Cartesian3 volcanoTip(-38500.0f, -4000.0f, 650.0f);
 
+Cartesian3 interpolate(const Cartesian3& previous, const Cartesian3& current, const float alpha) {
+    return previous + (current - previous) * alpha;
+}
+
 // Use maxFlightSpeed since it's the maximum translation in a single frame
 constexpr float planeRadius = static_cast<float>(maxFlightSpeed);
 
-constexpr int lavaBombsSpawnThreshold = 100;
+// Spawned aircraft fly this high above the terrain, measured in meters
+constexpr float minimumAircraftAltitude = 300.0f;
+constexpr float maximumAircraftAltitude = 1500.0f;
+// Measured in meters/tick
+constexpr float minimumAircraftSpeed = 3.0f;
+// Measured in degrees/tick, CCW or CW
+constexpr float maximumAircraftTurn = 0.5f;
+// Attempts at drawing a point over the terrain, per aircraft
+constexpr int aircraftPlacementAttempts = 16;
 
-constexpr float deltaTimeToSpawnParticle = 2.0f;
-// An explosion triggers 6 Lava Bombs to be spawned from collision point
+// Slices of lavaBombs checkLavaBombCollisions is split into, each a task of its own when updating on a pool
+constexpr std::size_t lavaBombCollisionParts = 8;
+
+// An explosion triggers lavaBombBudget.explosionFanOut Lava Bombs to be spawned from collision point
 constexpr float explosionProbability = 0.3f;
 
-Scene::Scene(const Cartesian3& initialPosition)
-    : shouldExit(false),
-      flightSpeed(0),
-      chronometer(0.0f) {
-    terrain.readTerrainFile(terrainName.data(), 500);
-    planeModel.readTriangleSoupFile(planeModelName.data());
-    lavaBombModel.readTriangleSoupFile(lavaBombModelName.data());
+// Lava bomb of lavaBombs, sorted by id, with id, or lavaBombs.end() if there is none
+std::vector<LavaBombParticle>::iterator findLavaBomb(std::vector<LavaBombParticle>& lavaBombs,
+                                                     const LavaBombId lavaBombId) {
+    const auto lavaBomb = std::lower_bound(
+        lavaBombs.begin(), lavaBombs.end(), lavaBombId,
+        [](const LavaBombParticle& l, const LavaBombId id) { return l.id < id; });
+    return lavaBomb != lavaBombs.end() && lavaBomb->id == lavaBombId ? lavaBomb : lavaBombs.end();
+}
+
+Scene::Scene(const Cartesian3& initialPosition, const char* obstacleFileName, const std::uint32_t seed)
+    : Scene(std::make_shared<const SceneAssets>(obstacleFileName), initialPosition, seed) {
+}
 
+Scene::Scene(std::shared_ptr<const SceneAssets> sharedAssets, const Cartesian3& initialPosition,
+             const std::uint32_t seed)
+    : assets(std::move(sharedAssets)),
+      terrain(assets->terrain),
+      planeModel(assets->planeModel),
+      lavaBombModel(assets->lavaBombModel),
+      obstacles(assets->obstacles),
+      crashedAircraft(0),
+      shouldExit(false),
+      crashCause(CrashCause::None),
+      ticks(0),
+      updatePhaseCounters(nullptr),
+      updatePool(nullptr),
+      flightSpeed(0),
+      nextLavaBombId(0),
+      chronometer(0.0f),
+      simulationTime(0.0),
+      random(seed),
+      updateGraph(std::vector<const char*>(sceneDataNames.begin(), sceneDataNames.end())),
+      updateTimeStep(0.0f),
+      peakLavaBombs(0),
+      peakLavaBombLandings(0) {
     /*
      * When modelling, z is commonly used for "vertical" with x-y used for "horizontal".
      * When rendering, the default is that we render using screen coordinates, so x is to the right,
@@ -68,6 +114,9 @@ Scene::Scene(const Cartesian3& initialPosition)
     planeRotation = Matrix4::identity();
 
     planePosition = initialPosition;
+
+    buildUpdateGraph();
+    reserveLavaBombCapacity();
 }
 
 void Scene::pitchUp() {
@@ -102,105 +151,634 @@ void Scene::decreaseSpeed() {
     flightSpeed = flightSpeed > minFlightSpeed ? flightSpeed - speedStep : minFlightSpeed;
 }
 
+void Scene::applyControl(const ControlInput control) {
+    switch (control) {
+        case ControlInput::PitchUp:
+            pitchUp();
+            break;
+        case ControlInput::PitchDown:
+            pitchDown();
+            break;
+        case ControlInput::RollLeft:
+            rollLeft();
+            break;
+        case ControlInput::RollRight:
+            rollRight();
+            break;
+        case ControlInput::YawLeft:
+            yawLeft();
+            break;
+        case ControlInput::YawRight:
+            yawRight();
+            break;
+        case ControlInput::IncreaseSpeed:
+            increaseSpeed();
+            break;
+        case ControlInput::DecreaseSpeed:
+            decreaseSpeed();
+            break;
+        case ControlInput::Exit:
+            shouldExit = true;
+            break;
+    }
+}
+
+void Scene::spawnLavaBombs(const unsigned int count) {
+    spawnLavaBombBurst(volcanoTip, count);
+    reserveLavaBombCapacity();
+    gatherLavaBombPositions();
+    updatePeakSizes();
+}
+
+unsigned int Scene::liveLavaBombs() const {
+    return static_cast<unsigned int>(lavaBombs.size());
+}
+
+void Scene::spawnAircraft(const unsigned int count) {
+    const std::size_t nRows = terrain.heightValues.size();
+    const std::size_t nColumns = nRows > 0 ? terrain.heightValues[0].size() : 0;
+    const float halfWidth = terrain.xyScale * static_cast<float>(nColumns) / 2.0f;
+    const float halfHeight = terrain.xyScale * static_cast<float>(nRows) / 2.0f;
+
+    for (unsigned int i = 0; i < count; i++) {
+        Cartesian3 position;
+        for (int attempt = 0; attempt < aircraftPlacementAttempts; attempt++) {
+            position.x = random.range(-halfWidth, halfWidth);
+            position.y = random.range(-halfHeight, halfHeight);
+            if (terrain.contains(position.x, position.y)) {
+                break;
+            }
+        }
+
+        // Aircraft left beyond the heightfield after every attempt fly from sea level
+        const float groundHeight = terrain.contains(position.x, position.y) ? terrain.getHeight(position.x, position.y)
+                                                                            : 0.0f;
+        position.z = groundHeight + random.range(minimumAircraftAltitude, maximumAircraftAltitude);
+
+        const float heading = random.range(0.0f, 360.0f);
+        const float speed = random.range(minimumAircraftSpeed, static_cast<float>(maxFlightSpeed));
+        const float turn = random.range(-maximumAircraftTurn, maximumAircraftTurn);
+        aircraft.add(position, heading, speed, 0.0f, turn);
+    }
+}
+
+#ifdef ENABLE_PHASE_TIMING
+bool Scene::writePhaseTimingsFile(const char* fileName) const {
+    std::ofstream outFile(fileName);
+    if (!outFile.good()) {
+        return false;
+    }
+
+    writePhaseCsvHeader(outFile);
+    writePhaseCsvRows(outFile, "update", updatePhaseTimings, updatePhaseNames);
+    writePhaseCsvRows(outFile, "render", renderPhaseTimings, renderPhaseNames);
+    return outFile.good();
+}
+#endif
+
+// FNV-1a over the bytes of value, floats are hashed by their bit patterns
+template <typename T>
+void hashValue(std::uint32_t& hash, const T& value) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (const unsigned char byte : bytes) {
+        hash = (hash ^ byte) * 16777619u;
+    }
+}
+
+MemoryReport Scene::memoryReport() const {
+    MemoryReport report = assets->memoryReport();
+
+    report.add("aircraft.", aircraft.memoryReport());
+    report.add("lavaBombs", lavaBombs, peakLavaBombs);
+    report.add("lavaBombLandings", lavaBombLandings.container(), peakLavaBombLandings);
+    report.add("lavaBombPositions.x", lavaBombPositions.x, peakLavaBombs);
+    report.add("lavaBombPositions.y", lavaBombPositions.y, peakLavaBombs);
+    report.add("lavaBombPositions.z", lavaBombPositions.z, peakLavaBombs);
+    report.add("lavaBombCollisionHits", lavaBombCollisionHits, peakLavaBombs * lavaBombCollisionParts);
+    report.add("planeCollisionHits", planeCollisionHits, std::max(peakLavaBombs, aircraft.size()));
+    report.add("frameArena", 1, frameArena.used(), frameArena.capacity(), frameArena.highWater());
+    return report;
+}
+
+std::uint32_t Scene::stateHash() const {
+    std::uint32_t hash = 2166136261u;
+
+    hashValue(hash, ticks);
+    hashValue(hash, planePosition);
+    hashValue(hash, planeRotation.coordinates);
+    hashValue(hash, flightSpeed);
+    hashValue(hash, chronometer);
+    hashValue(hash, shouldExit);
+    hashValue(hash, random);
+
+    for (const auto& lavaBomb : lavaBombs) {
+        hashValue(hash, lavaBomb.id);
+        hashValue(hash, lavaBomb.position);
+        hashValue(hash, lavaBomb.isAlive);
+    }
+
+    hashValue(hash, crashedAircraft);
+    for (std::size_t i = 0; i < aircraft.size(); i++) {
+        hashValue(hash, aircraft.position(i));
+        hashValue(hash, aircraft.headingX[i]);
+        hashValue(hash, aircraft.headingY[i]);
+    }
+
+    return hash;
+}
+
+void Scene::saveState(std::vector<std::uint8_t>& state) const {
+    state.clear();
+    StateWriter writer(state);
+
+    writer.write(sceneStateMagic);
+    writer.write(sceneStateVersion);
+
+    writer.write(static_cast<std::uint64_t>(ticks));
+    writer.write(simulationTime);
+    writer.write(chronometer);
+    writer.write(shouldExit);
+    writer.write(crashCause);
+    writer.write(lavaBombBudget);
+    writer.write(random);
+
+    writer.write(planePosition);
+    writer.write(planeTranslation);
+    writer.write(planeRotation);
+    writer.write(flightSpeed);
+
+    writer.write(nextLavaBombId);
+    LavaBombParticle::writeState(writer, lavaBombs);
+    writer.writeArray(lavaBombLandings.container());
+
+    writer.write(static_cast<std::uint64_t>(crashedAircraft));
+    aircraft.writeState(writer);
+}
+
+bool Scene::restoreState(const std::vector<std::uint8_t>& state) {
+    StateReader reader(state.data(), state.size());
+
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    if (!reader.read(magic) || magic != sceneStateMagic || !reader.read(version) || version != sceneStateVersion) {
+        return false;
+    }
+
+    // Read aside first, so that a malformed state leaves the scene as it was
+    std::uint64_t restoredTicks = 0;
+    double restoredSimulationTime = 0.0;
+    float restoredChronometer = 0.0f;
+    bool restoredShouldExit = false;
+    CrashCause restoredCrashCause = CrashCause::None;
+    LavaBombBudget restoredLavaBombBudget;
+    Random restoredRandom;
+    Cartesian3 restoredPlanePosition;
+    Cartesian3 restoredPlaneTranslation;
+    Matrix4 restoredPlaneRotation;
+    Speed restoredFlightSpeed = 0;
+    LavaBombId restoredNextLavaBombId = 0;
+    std::vector<LavaBombParticle> restoredLavaBombs;
+    std::vector<LavaBombLanding> restoredLavaBombLandings;
+    std::uint64_t restoredCrashedAircraft = 0;
+    AircraftStore restoredAircraft;
+
+    if (!reader.read(restoredTicks) || !reader.read(restoredSimulationTime) || !reader.read(restoredChronometer) ||
+        !reader.read(restoredShouldExit) || !reader.read(restoredCrashCause) ||
+        !reader.read(restoredLavaBombBudget) || !reader.read(restoredRandom) ||
+        !reader.read(restoredPlanePosition) || !reader.read(restoredPlaneTranslation) ||
+        !reader.read(restoredPlaneRotation) || !reader.read(restoredFlightSpeed) ||
+        !reader.read(restoredNextLavaBombId) || !LavaBombParticle::readState(reader, restoredLavaBombs) ||
+        !reader.readArray(restoredLavaBombLandings) || !reader.read(restoredCrashedAircraft) ||
+        !restoredAircraft.readState(reader) || !reader.atEnd()) {
+        return false;
+    }
+
+    ticks = restoredTicks;
+    simulationTime = restoredSimulationTime;
+    chronometer = restoredChronometer;
+    shouldExit = restoredShouldExit;
+    crashCause = restoredCrashCause;
+    lavaBombBudget = restoredLavaBombBudget;
+    random = restoredRandom;
+    planePosition = restoredPlanePosition;
+    planeTranslation = restoredPlaneTranslation;
+    planeRotation = restoredPlaneRotation;
+    flightSpeed = restoredFlightSpeed;
+    nextLavaBombId = restoredNextLavaBombId;
+    lavaBombs.swap(restoredLavaBombs);
+    lavaBombLandings.container().swap(restoredLavaBombLandings);
+    crashedAircraft = restoredCrashedAircraft;
+    aircraft = std::move(restoredAircraft);
+
+    // Swapped in at their restored size, and derived from the restored lava bombs, the next update refreshes them anyway
+    reserveLavaBombCapacity();
+    gatherLavaBombPositions();
+    updatePeakSizes();
+    return true;
+}
+
 void Scene::update(const float timeStep) {
+    ticks++;
     chronometer += timeStep;
+    simulationTime += timeStep;
+    // The budget may have grown since the previous update
+    reserveLavaBombCapacity();
+    frameArena.reset();
+    updateTimeStep = timeStep;
 
-    movePlane();
-    updateLavaBombs(timeStep);
-    checkPlaneCollision();
-    checkLavaBombCollisions();
-    refreshLavaBombs();
+    updateGraph.run(updatePhaseCounters ? nullptr : updatePool);
+
+    if constexpr (phaseTimingEnabled) {
+        for (std::size_t phase = 0; phase < updatePhaseCount; phase++) {
+            updatePhaseTimings.record(phase, updateGraph.duration(phase));
+        }
+    }
+    updatePeakSizes();
+}
+
+void Scene::buildUpdateGraph() {
+    const AccessSet plane = sceneData(SceneData::Plane);
+    const AccessSet aircraftData = sceneData(SceneData::Aircraft);
+    const AccessSet lavaBombData = sceneData(SceneData::LavaBombs);
+    const AccessSet positions = sceneData(SceneData::LavaBombPositions);
+    const AccessSet lavaBombHits = sceneData(SceneData::LavaBombCollisionHits);
+    const AccessSet planeHits = sceneData(SceneData::PlaneCollisionHits);
+    const AccessSet clocks = sceneData(SceneData::Clocks);
+
+    // Added in UpdatePhase order, so that task indices are phases, which is also the order of serial updates
+    const std::size_t movePlaneTask = updateGraph.add(
+        updatePhaseNames[0], 0, plane, {},
+        [this](std::size_t, std::size_t) { movePlane(); });
+    const std::size_t moveAircraftTask = updateGraph.add(
+        updatePhaseNames[1], 0, aircraftData, {},
+        [this](std::size_t, std::size_t) { moveAircraft(); });
+    const std::size_t updateLavaBombsTask = updateGraph.add(
+        updatePhaseNames[2], clocks, lavaBombData | positions | lavaBombHits, {},
+        [this](std::size_t, std::size_t) { updateLavaBombs(updateTimeStep); });
+
+    // The plane is checked against aircraft before they are, as aircraft that crash are erased
+    const std::size_t checkPlaneCollisionTask = updateGraph.add(
+        updatePhaseNames[3], plane | aircraftData | positions, sceneData(SceneData::Crash) | planeHits,
+        {movePlaneTask, moveAircraftTask, updateLavaBombsTask},
+        [this](std::size_t, std::size_t) { checkPlaneCollision(); });
+    updateGraph.add(
+        updatePhaseNames[4], positions, aircraftData, {checkPlaneCollisionTask},
+        [this](std::size_t, std::size_t) { checkAircraftCollisions(); });
+
+    // Lava bombs only depend on one another from here on, alongside the plane & aircraft
+    const std::size_t checkLavaBombCollisionsTask = updateGraph.add(
+        updatePhaseNames[5], positions, lavaBombData | lavaBombHits, {updateLavaBombsTask},
+        [this](const std::size_t firstPart, const std::size_t endPart) {
+            checkLavaBombCollisions(firstPart, endPart);
+        },
+        lavaBombCollisionParts);
+    updateGraph.add(
+        updatePhaseNames[6], 0,
+        lavaBombData | clocks | sceneData(SceneData::Random) | sceneData(SceneData::FrameArena),
+        {checkLavaBombCollisionsTask},
+        [this](std::size_t, std::size_t) { refreshLavaBombs(); });
+}
+
+void Scene::updatePeakSizes() {
+    peakLavaBombs = std::max(peakLavaBombs, lavaBombs.size());
+    peakLavaBombLandings = std::max(peakLavaBombLandings, lavaBombLandings.size());
 }
 
 void Scene::movePlane() {
+    TRACE_SCOPE("update", "movePlane");
+    COUNT_PHASE(updatePhaseCounters, UpdatePhase::MovePlane);
+
+    planeTranslation = Cartesian3();
+
     if (flightSpeed > 0) {
         // Rotations don't affect length of vector
         // Since forward is a unit vector, || direction || = || planeRotation * forward || = 1
         // || translation || = || flightSpeed * direction || = flightSpeed * || direction || = flightSpeed
         // Therefore, the translation is always flightSpeed distance in forward direction
-        const Cartesian3 translation = flightSpeed * (planeRotation * forward);
-        planePosition = planePosition + translation;
+        planeTranslation = flightSpeed * (planeRotation * forward);
+        planePosition = planePosition + planeTranslation;
     }
 }
 
+void Scene::moveAircraft() {
+    TRACE_SCOPE("update", "moveAircraft");
+    COUNT_PHASE(updatePhaseCounters, UpdatePhase::MoveAircraft);
+
+    aircraft.move();
+}
+
 void Scene::updateLavaBombs(float timeStep) {
+    TRACE_SCOPE("update", "updateLavaBombs");
+    COUNT_PHASE(updatePhaseCounters, UpdatePhase::UpdateLavaBombs);
+
     for (auto& lavaBomb : lavaBombs) {
         if (lavaBomb.isAlive) {
             lavaBomb.update(timeStep);
         }
     }
+
+    retireLandedLavaBombs();
+    gatherLavaBombPositions();
+}
+
+void Scene::gatherLavaBombPositions() {
+    CHECK_TASK_ACCESS(sceneData(SceneData::LavaBombs),
+                      sceneData(SceneData::LavaBombPositions) | sceneData(SceneData::LavaBombCollisionHits));
+
+    lavaBombPositions.clear();
+    for (const auto& lavaBomb : lavaBombs) {
+        lavaBombPositions.push_back(lavaBomb.position);
+    }
+
+    lavaBombCollisionHits.resize(lavaBombs.size() * lavaBombCollisionParts);
+}
+
+void Scene::retireLandedLavaBombs() {
+    CHECK_TASK_ACCESS(sceneData(SceneData::Clocks), sceneData(SceneData::LavaBombs));
+
+    while (!lavaBombLandings.empty() && lavaBombLandings.top().time <= simulationTime) {
+        const LavaBombId lavaBombId = lavaBombLandings.top().lavaBombId;
+        lavaBombLandings.pop();
+
+        const auto lavaBomb = findLavaBomb(lavaBombs, lavaBombId);
+        if (lavaBomb != lavaBombs.end()) {
+            lavaBomb->isAlive = false;
+        }
+    }
+}
+
+void Scene::spawnLavaBombBurst(const Cartesian3& position, const unsigned int count) {
+    CHECK_TASK_ACCESS(sceneData(SceneData::Clocks), sceneData(SceneData::LavaBombs) |
+                      sceneData(SceneData::Random) | sceneData(SceneData::FrameArena));
+
+    Cartesian3* velocities = frameArena.allocate<Cartesian3>(count);
+    random.upwardsConeVelocities(velocities, count, directionAngleRange, minParticleSpeed, maxParticleSpeed);
+
+    for (unsigned int i = 0; i < count; i++) {
+        const LavaBombParticle& lavaBomb = lavaBombs.emplace_back(nextLavaBombId++, position,
+                                                                  velocities[i], terrain, obstacles);
+        lavaBombLandings.push({simulationTime + lavaBomb.landingLifespan, lavaBomb.id, 0});
+    }
 }
 
 void Scene::checkPlaneCollision() {
+    TRACE_SCOPE("update", "checkPlaneCollision");
+    COUNT_PHASE(updatePhaseCounters, UpdatePhase::CheckPlaneCollision);
+
     // Check crash against terrain
     // This accounts for crashes from above or below the terrain
-    const auto terrainPoint = Cartesian3(
-        planePosition.x,
-        planePosition.y,
-        terrain.getHeight(planePosition.x, planePosition.y));
+    // There is no terrain to crash against beyond the heightfield
+    if (terrain.contains(planePosition.x, planePosition.y)) {
+        const auto terrainPoint = Cartesian3(
+            planePosition.x,
+            planePosition.y,
+            terrain.getHeight(planePosition.x, planePosition.y));
+
+        if (isSpherePointCollision(planePosition, planeRadius, terrainPoint)) {
+            crash(CrashCause::Terrain);
+        }
+    }
+
+    // Broad phase bounds the plane swept along its latest translation, which is at most planeRadius long
+    const float broadPhaseRadius = planeRadius + planeModel.convexHull.boundingRadius();
+
+    PlacedConvexHull plane;
+    plane.hull = &planeModel.convexHull;
+    plane.rotation = planeRotation;
+    plane.position = planePosition - planeTranslation;
+    plane.sweep = planeTranslation;
 
-    if (isSpherePointCollision(planePosition, planeRadius, terrainPoint)) {
-        shouldExit = true;
+    // Check collision against static obstacles, narrow phase included
+    if (obstacles.isCollision(plane, planePosition, broadPhaseRadius)) {
+        crash(CrashCause::Obstacle);
+    }
+
+    // Check collision against other aircraft, narrow phase included
+    const PointSpan aircraftPositions = aircraft.positions.span();
+    const PointSpan lavaBombSpan = lavaBombPositions.span();
+    planeCollisionHits.resize(std::max(aircraftPositions.count, lavaBombSpan.count));
+    const std::size_t nAircraftHits = allSphereSphereCollisions(
+        planePosition, broadPhaseRadius, aircraftPositions, planeModel.convexHull.boundingRadius(),
+        planeCollisionHits.data());
+
+    PlacedConvexHull otherAircraft;
+    otherAircraft.hull = &planeModel.convexHull;
+
+    for (std::size_t hit = 0; hit < nAircraftHits; hit++) {
+        otherAircraft.rotation = aircraft.rotation(planeCollisionHits[hit]);
+        otherAircraft.position = aircraft.position(planeCollisionHits[hit]);
+        if (isConvexHullCollision(plane, otherAircraft)) {
+            crash(CrashCause::Aircraft);
+            break;
+        }
     }
 
     // Check collision against each lava bomb
-    for (const auto& lavaBomb : lavaBombs) {
-        if (isSphereSphereCollision(planePosition, planeRadius, lavaBomb.position, lavaBombRadius)) {
-            shouldExit = true;
+    const std::size_t nHits = allSphereSphereCollisions(
+        planePosition, broadPhaseRadius, lavaBombSpan, lavaBombRadius, planeCollisionHits.data());
+    if (nHits == 0) {
+        return;
+    }
+
+    // Narrow phase against the actual plane & lava bomb models
+    // Positions are read from lavaBombPositions, as refreshLavaBombs may be reshaping lavaBombs meanwhile
+    PlacedConvexHull lavaBomb;
+    lavaBomb.hull = &lavaBombModel.convexHull;
+
+    for (std::size_t hit = 0; hit < nHits; hit++) {
+        const std::uint32_t index = planeCollisionHits[hit];
+        lavaBomb.position = Cartesian3(lavaBombSpan.x[index], lavaBombSpan.y[index], lavaBombSpan.z[index]);
+        if (isConvexHullCollision(plane, lavaBomb)) {
+            crash(CrashCause::LavaBomb);
+            return;
         }
     }
 }
 
-void Scene::checkLavaBombCollisions() {
-    for (unsigned int l1 = 0; l1 < lavaBombs.size(); l1++) {
-        auto& lavaBomb = lavaBombs[l1];
+void Scene::crash(const CrashCause cause) {
+    CHECK_TASK_ACCESS(0, sceneData(SceneData::Crash));
+
+    shouldExit = true;
+    if (crashCause == CrashCause::None) {
+        crashCause = cause;
+    }
+}
+
+void Scene::checkAircraftCollisions() {
+    TRACE_SCOPE("update", "checkAircraftCollisions");
+    COUNT_PHASE(updatePhaseCounters, UpdatePhase::CheckAircraftCollisions);
+
+    const float aircraftRadius = planeModel.convexHull.boundingRadius();
+
+    aircraft.checkTerrainCollisions(terrain, aircraftRadius);
+    aircraft.checkLavaBombCollisions(lavaBombPositions.span(), aircraftRadius, lavaBombRadius);
+    crashedAircraft += aircraft.removeCrashed();
+}
+
+void Scene::checkLavaBombCollisions(const std::size_t firstPart, const std::size_t endPart) {
+    TRACE_SCOPE("update", "checkLavaBombCollisions");
+    COUNT_PHASE(updatePhaseCounters, UpdatePhase::CheckLavaBombCollisions);
 
+    const PointSpan positions = lavaBombPositions.span();
+    const std::size_t n = lavaBombs.size();
+    // Slices of the scratch space are per part, so that parts may run concurrently
+    std::uint32_t* hits = lavaBombCollisionHits.data() + firstPart * n;
+
+    const std::size_t begin = n * firstPart / lavaBombCollisionParts;
+    const std::size_t end = n * endPart / lavaBombCollisionParts;
+    for (std::size_t i = begin; i < end; i++) {
         // Avoid unnecessary collisions
-        // If more than 2 lava bombs are within collision range it will get detected
-        if (!lavaBomb.isAlive) {
+        // Dead lava bombs are erased regardless, and those colliding with them check their own collisions
+        if (!lavaBombs[i].isAlive) {
+            continue;
+        }
+
+        const std::size_t nCollisions = lavaBombs[i].findCollisions(lavaBombs, positions, hits);
+        if (nCollisions == 0) {
             continue;
         }
 
-        for (unsigned int l2 = 0; l2 < lavaBombs.size(); l2++) {
-            // Avoid self-collisions
-            if (l1 != l2) {
-                lavaBomb.checkCollision(lavaBombs[l2]);
+        // Lava bombs of other parts are left for those parts to flag, as they may be checking them meanwhile
+        lavaBombs[i].isAlive = false;
+        for (std::size_t collision = 0; collision < nCollisions; collision++) {
+            if (hits[collision] >= begin && hits[collision] < end) {
+                lavaBombs[hits[collision]].isAlive = false;
             }
         }
     }
 }
 
 void Scene::refreshLavaBombs() {
-    for (unsigned int i = 0; i < lavaBombs.size(); i++) {
-        auto& lavaBomb = lavaBombs[i];
-
-        if (!lavaBombs[i].isAlive) {
-            lavaBombs.erase(lavaBombs.begin() + i);
-            lavaBombCollisionPoints.emplace_back(lavaBomb.position);
+    TRACE_SCOPE("update", "refreshLavaBombs");
+    COUNT_PHASE(updatePhaseCounters, UpdatePhase::RefreshLavaBombs);
+
+    // Move live lava bombs down over dead ones in a single pass, which keeps them sorted by id
+    Cartesian3* collisionPoints = frameArena.allocate<Cartesian3>(lavaBombs.size());
+    std::size_t nCollisionPoints = 0;
+    std::size_t nAlive = 0;
+    for (std::size_t i = 0; i < lavaBombs.size(); i++) {
+        if (lavaBombs[i].isAlive) {
+            if (nAlive != i) {
+                lavaBombs[nAlive] = lavaBombs[i];
+            }
+            nAlive++;
+        } else {
+            collisionPoints[nCollisionPoints++] = lavaBombs[i].position;
         }
     }
+    lavaBombs.erase(lavaBombs.begin() + static_cast<std::ptrdiff_t>(nAlive), lavaBombs.end());
+
+    // Events of landed lava bombs were popped as they fired, any left over belong to lava bombs which collided
+    if (lavaBombLandings.size() > lavaBombs.size()) {
+        dropStaleLavaBombLandings();
+    }
 
-    // Spawn 6 lava bombs from collision point of colliding lava bombs
+    // Spawn explosionFanOut lava bombs from collision point of colliding lava bombs
     // With a probability of explosionProbability per collision point
-    for (const auto& collisionPoint : lavaBombCollisionPoints) {
-        if (const float roll = randomRange(0.0, 1.0f); roll > explosionProbability) {
+    for (std::size_t i = 0; i < nCollisionPoints; i++) {
+        if (const float roll = random.unit(); roll > explosionProbability) {
             continue;
         }
 
-        for (int i = 0; i < 6; i++) {
-            lavaBombs.emplace_back(collisionPoint, &terrain);
+        if (lavaBombs.size() < lavaBombBudget.maximumLiveLavaBombs) {
+            const auto room = static_cast<unsigned int>(lavaBombBudget.maximumLiveLavaBombs - lavaBombs.size());
+            spawnLavaBombBurst(collisionPoints[i], std::min(lavaBombBudget.explosionFanOut, room));
         }
     }
-    lavaBombCollisionPoints.clear();
 
     // No need to do epsilon comparison, fine-grained accuracy is not needed
-    if (chronometer >= deltaTimeToSpawnParticle && lavaBombs.size() < lavaBombsSpawnThreshold) {
+    if (chronometer >= lavaBombBudget.spawnInterval && lavaBombs.size() < lavaBombBudget.maximumLiveLavaBombs) {
         chronometer = 0.0f;
-        lavaBombs.emplace_back(volcanoTip, &terrain);
+        spawnLavaBombBurst(volcanoTip, 1);
+    }
+}
+
+void Scene::dropStaleLavaBombLandings() {
+    std::vector<LavaBombLanding>& landings = lavaBombLandings.container();
+    landings.erase(std::remove_if(landings.begin(), landings.end(),
+                                  [this](const LavaBombLanding& landing) {
+                                      return findLavaBomb(lavaBombs, landing.lavaBombId) == lavaBombs.end();
+                                  }),
+                   landings.end());
+    std::make_heap(landings.begin(), landings.end(), std::greater<LavaBombLanding>());
+}
+
+void Scene::reserveLavaBombCapacity() {
+    // Upfront lava bombs may exceed the budget, no more are spawned until they no longer do
+    const std::size_t capacity = std::max<std::size_t>(lavaBombBudget.maximumLiveLavaBombs, lavaBombs.size());
+    lavaBombs.reserve(capacity);
+    lavaBombLandings.container().reserve(capacity);
+    lavaBombPositions.reserve(capacity);
+    lavaBombCollisionHits.reserve(capacity * lavaBombCollisionParts);
+    planeCollisionHits.reserve(std::max(capacity, aircraft.size()));
+    // Collision points of every lava bomb, and velocities of as many lava bombs spawned to replace them
+    frameArena.reserve(2 * capacity * sizeof(Cartesian3));
+}
+
+void Scene::captureSnapshot(SceneSnapshot& snapshot) const {
+    snapshot.tick = ticks;
+    snapshot.planePosition = planePosition;
+    snapshot.previousPlanePosition = planePosition - planeTranslation;
+    snapshot.planeRotation = planeRotation;
+    snapshot.shouldExit = shouldExit;
+
+    snapshot.lavaBombIds.clear();
+    snapshot.lavaBombPositions.clear();
+    snapshot.previousLavaBombPositions.clear();
+    for (const auto& lavaBomb : lavaBombs) {
+        snapshot.lavaBombIds.push_back(lavaBomb.id);
+        snapshot.lavaBombPositions.push_back(lavaBomb.position);
+        snapshot.previousLavaBombPositions.push_back(lavaBomb.previousPosition);
+    }
+
+    snapshot.aircraftIds.assign(aircraft.ids.begin(), aircraft.ids.end());
+    snapshot.aircraftPositions.clear();
+    snapshot.previousAircraftPositions.clear();
+    snapshot.aircraftHeadings.clear();
+    for (std::size_t i = 0; i < aircraft.size(); i++) {
+        snapshot.aircraftPositions.push_back(aircraft.position(i));
+        snapshot.previousAircraftPositions.emplace_back(aircraft.previousPositions.x[i],
+                                                        aircraft.previousPositions.y[i],
+                                                        aircraft.previousPositions.z[i]);
+        snapshot.aircraftHeadings.emplace_back(aircraft.headingX[i], aircraft.headingY[i], 0.0f);
+    }
+}
+
+void Scene::captureTelemetry(TelemetryRecord& record) const {
+    record.tick = ticks;
+    record.simulationTime = static_cast<float>(simulationTime);
+    record.planePosition[0] = planePosition.x;
+    record.planePosition[1] = planePosition.y;
+    record.planePosition[2] = planePosition.z;
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            record.planeRotation[3 * row + column] = planeRotation[row][column];
+        }
+    }
+    record.flightSpeed = static_cast<float>(flightSpeed);
+    record.liveLavaBombs = liveLavaBombs();
+    record.aircraft = static_cast<std::uint32_t>(aircraft.size());
+    record.crashCause = static_cast<std::uint32_t>(crashCause);
+    for (std::size_t phase = 0; phase < updatePhaseCount; phase++) {
+        record.updatePhaseTimes[phase] = updatePhaseTimings.latest(phase);
     }
 }
 
-void Scene::render() {
+void Scene::render(const SceneSnapshot& snapshot, const float alpha) {
+    prepareRender(snapshot);
+    updateCameraMatrix(snapshot, alpha);
+
+    renderTerrain();
+    renderObstacles();
+    renderAircraft(snapshot, alpha);
+    renderLavaBombs(snapshot, alpha);
+}
+
+void Scene::prepareRender(const SceneSnapshot& snapshot) {
+    TIME_PHASE(renderPhaseTimings, RenderPhase::Setup);
+    TRACE_SCOPE("render", "setup");
+
     // enable Z-buffering
     glEnable(GL_DEPTH_TEST);
 
@@ -222,7 +800,7 @@ void Scene::render() {
     // compute the light position
     // Translation matrices don't affect rotation component
     // (W2OGL * R^T) is the rotation component of the terrain viewMatrix
-    Homogeneous4 lightDirection = world2OpenGLMatrix * planeRotation.transpose() * sunDirection;
+    Homogeneous4 lightDirection = world2OpenGLMatrix * snapshot.planeRotation.transpose() * sunDirection;
     // and set the w to zero to force infinite distance
     lightDirection.w = 0.0;
 
@@ -233,30 +811,58 @@ void Scene::render() {
     glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, groundColour.data());
     glMaterialfv(GL_FRONT, GL_SPECULAR, blackColour.data());
     glMaterialfv(GL_FRONT, GL_EMISSION, blackColour.data());
-
-    updateCameraMatrix();
-
-    renderTerrain();
-    renderLavaBombs();
 }
 
-void Scene::updateCameraMatrix() {
+void Scene::updateCameraMatrix(const SceneSnapshot& snapshot, const float alpha) {
+    const Cartesian3 cameraPosition = interpolate(snapshot.previousPlanePosition, snapshot.planePosition, alpha);
+
     // C^(-1) = (T * R)^-1 = R^(-1) * T^(-1) = R^T * (-T)
-    inverseCameraMatrix = planeRotation.transpose() * Matrix4::translation(-planePosition);
+    inverseCameraMatrix = snapshot.planeRotation.transpose() * Matrix4::translation(-cameraPosition);
 }
 
-void Scene::renderTerrain() const {
+void Scene::renderTerrain() {
+    TIME_PHASE(renderPhaseTimings, RenderPhase::Terrain);
+    TRACE_SCOPE("render", "terrain");
+
     const Matrix4 terrainViewMatrix = computeViewMatrix(worldOrigin);
     terrain.render(terrainViewMatrix);
 }
 
-void Scene::renderLavaBombs() {
-    for (const auto& lavaBomb : lavaBombs) {
-        Matrix4 lavaBombMatrix = computeViewMatrix(lavaBomb.position);
+void Scene::renderLavaBombs(const SceneSnapshot& snapshot, const float alpha) {
+    TIME_PHASE(renderPhaseTimings, RenderPhase::LavaBombs);
+    TRACE_SCOPE("render", "lavaBombs");
+
+    for (size_t l = 0; l < snapshot.lavaBombPositions.size(); l++) {
+        const Cartesian3 lavaBombPosition = interpolate(
+            snapshot.previousLavaBombPositions[l], snapshot.lavaBombPositions[l], alpha);
+        Matrix4 lavaBombMatrix = computeViewMatrix(lavaBombPosition);
         lavaBombModel.render(lavaBombMatrix);
     }
 }
 
+void Scene::renderObstacles() {
+    TIME_PHASE(renderPhaseTimings, RenderPhase::Obstacles);
+    TRACE_SCOPE("render", "obstacles");
+
+    obstacles.render(computeViewMatrix(worldOrigin));
+}
+
+void Scene::renderAircraft(const SceneSnapshot& snapshot, const float alpha) {
+    TIME_PHASE(renderPhaseTimings, RenderPhase::Aircraft);
+    TRACE_SCOPE("render", "aircraft");
+
+    glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, planeColour.data());
+
+    for (std::size_t i = 0; i < snapshot.aircraftPositions.size(); i++) {
+        const Cartesian3 aircraftPosition = interpolate(
+            snapshot.previousAircraftPositions[i], snapshot.aircraftPositions[i], alpha);
+        const Cartesian3& heading = snapshot.aircraftHeadings[i];
+        planeModel.render(computeViewMatrix(aircraftPosition) * AircraftStore::headingRotation(heading.x, heading.y));
+    }
+
+    glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, groundColour.data());
+}
+
 Matrix4 Scene::computeViewMatrix(const Cartesian3& position) const {
     // 1. Translate the point in world coordinates to position
     // 2. Move and rotate the world inversely respect to the camera
@@ -1,11 +1,31 @@
 #ifndef SCENE
 #define SCENE
 
+#include <array>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "AircraftStore.h"
+#include "ControlInput.h"
 #include "HomogeneousFaceSurface.h"
 #include "Matrix4.h"
 #include "Terrain.h"
 #include "LavaBombParticle.h"
 #include "Cartesian3.h"
+#include "FrameArena.h"
+#include "MemoryReport.h"
+#include "ObstacleLayer.h"
+#include "PerformanceCounters.h"
+#include "PhaseTimer.h"
+#include "Random.h"
+#include "SceneAssets.h"
+#include "SceneSnapshot.h"
+#include "SphereCollision.h"
+#include "TaskGraph.h"
+
+struct TelemetryRecord;
 
 // Measured in meters/frame
 typedef unsigned int Speed;
@@ -17,24 +37,241 @@ constexpr Speed speedStep = 1;
 
 const Cartesian3 forward(0.0, 1.0f, 0.0);
 
+// Limits on the lava bomb load, the defaults keep the volcano's original spawn interval, fan-out & live limit
+// Unlike originally, the live limit caps explosions as well as the volcano, so the load never exceeds it
+struct LavaBombBudget {
+    // Measured in seconds, time between lava bombs spawned from the volcano
+    float spawnInterval = 2.0f;
+    // Lava bombs spawned by an explosion
+    unsigned int explosionFanOut = 6;
+    // No lava bombs are spawned, by the volcano or explosions, while this many are alive
+    unsigned int maximumLiveLavaBombs = 100;
+};
+
+// Phases of Scene::update, in the order they run
+enum class UpdatePhase {
+    MovePlane,
+    MoveAircraft,
+    UpdateLavaBombs,
+    CheckPlaneCollision,
+    CheckAircraftCollisions,
+    CheckLavaBombCollisions,
+    RefreshLavaBombs
+};
+
+constexpr std::size_t updatePhaseCount = 7;
+
+const std::array<const char*, updatePhaseCount> updatePhaseNames = {
+    "movePlane",
+    "moveAircraft",
+    "updateLavaBombs",
+    "checkPlaneCollision",
+    "checkAircraftCollisions",
+    "checkLavaBombCollisions",
+    "refreshLavaBombs"
+};
+
+// Data the phases of Scene::update read & write, one bit each of an AccessSet, see sceneData
+// Data left out is never written during an update, e.g. the assets & lavaBombBudget, so any phase may read it
+enum class SceneData {
+    // planePosition, planeTranslation, planeRotation & flightSpeed
+    Plane,
+    // aircraft & crashedAircraft
+    Aircraft,
+    // lavaBombs, nextLavaBombId & lavaBombLandings
+    LavaBombs,
+    LavaBombPositions,
+    LavaBombCollisionHits,
+    PlaneCollisionHits,
+    // shouldExit & crashCause
+    Crash,
+    // simulationTime & chronometer
+    Clocks,
+    Random,
+    FrameArena
+};
+
+constexpr std::size_t sceneDataCount = 10;
+
+const std::array<const char*, sceneDataCount> sceneDataNames = {
+    "plane",
+    "aircraft",
+    "lavaBombs",
+    "lavaBombPositions",
+    "lavaBombCollisionHits",
+    "planeCollisionHits",
+    "crash",
+    "clocks",
+    "random",
+    "frameArena"
+};
+
+constexpr AccessSet sceneData(const SceneData data) {
+    return AccessSet(1) << static_cast<unsigned int>(data);
+}
+
+// Passes of Scene::render, in the order they run
+// They measure the time spent issuing OpenGL calls, the GPU may still be drawing afterwards
+enum class RenderPhase {
+    Setup,
+    Terrain,
+    Obstacles,
+    Aircraft,
+    LavaBombs
+};
+
+constexpr std::size_t renderPhaseCount = 5;
+
+const std::array<const char*, renderPhaseCount> renderPhaseNames = {
+    "setup",
+    "terrain",
+    "obstacles",
+    "aircraft",
+    "lavaBombs"
+};
+
+// What the plane crashed into first
+enum class CrashCause {
+    None,
+    Terrain,
+    Obstacle,
+    Aircraft,
+    LavaBomb
+};
+
+const std::array<const char*, 5> crashCauseNames = {
+    "none",
+    "terrain",
+    "obstacle",
+    "aircraft",
+    "lavaBomb"
+};
+
+// Scheduled retirement of a lava bomb, once it lands, see LavaBombParticle::landingLifespan
+// Every live lava bomb has exactly one, dropped along with the lava bomb if it dies colliding with another first
+struct LavaBombLanding {
+    // Measured in seconds of simulation time, see Scene::simulationTime
+    double time;
+    LavaBombId lavaBombId;
+    // Always 0, spelled out so that saved states hold no uninitialized padding
+    std::uint32_t padding;
+
+    bool operator >(const LavaBombLanding& other) const {
+        return time > other.time;
+    }
+};
+
+// Min-heap on landing time
+class LavaBombLandingQueue
+    : public std::priority_queue<LavaBombLanding, std::vector<LavaBombLanding>, std::greater<LavaBombLanding>> {
+public:
+    // Underlying storage, for memory reports
+    const std::vector<LavaBombLanding>& container() const {
+        return c;
+    }
+
+    // Underlying storage, for saved states, which keep it as is since it already is a heap
+    std::vector<LavaBombLanding>& container() {
+        return c;
+    }
+};
+
 class Scene {
 public:
-    Terrain terrain;
-    HomogeneousFaceSurface planeModel;
-    HomogeneousFaceSurface lavaBombModel;
+    // Possibly shared with other Scenes, see SceneAssets
+    const std::shared_ptr<const SceneAssets> assets;
+    const Terrain& terrain;
+    const HomogeneousFaceSurface& planeModel;
+    const HomogeneousFaceSurface& lavaBombModel;
+    const ObstacleLayer& obstacles;
+
+    // Aircraft besides the player's, rendered with planeModel
+    // They crash into the terrain and lava bombs, and the player crashes into them
+    AircraftStore aircraft;
+
+    // Number of aircraft crashed, and erased from aircraft, so far
+    unsigned long crashedAircraft;
 
     // (x, y, z) |-> (x, z, -y)
     Matrix4 world2OpenGLMatrix;
 
     bool shouldExit;
 
-    Scene(const Cartesian3& initialPosition);
+    // Set along with shouldExit by the first crash, the Exit control leaves it as None
+    CrashCause crashCause;
+
+    LavaBombBudget lavaBombBudget;
+
+    // Number of updates so far
+    unsigned long ticks;
+
+    // Wall time spent in each UpdatePhase, only touched by the thread calling update
+    PhaseTimings<updatePhaseCount> updatePhaseTimings;
+
+    // Wall time spent in each RenderPhase, only touched by the thread calling render
+    PhaseTimings<renderPhaseCount> renderPhaseTimings;
+
+    // Optional hardware counters summed per UpdatePhase, opened by the thread calling update
+    PhaseCounters<updatePhaseCount>* updatePhaseCounters;
+
+    // Optional pool running the phases of update concurrently, as far as the data they access allows, see updateGraph
+    // Null runs them serially on the thread calling update, as do hardware counters, which only count that thread
+    // Either way, scenes with the same seed and inputs evolve identically
+    WorkStealingPool* updatePool;
+
+    // obstacleFileName optionally names a .obs file of static obstacles to place in the world
+    // Scenes with the same seed and inputs evolve identically
+    Scene(const Cartesian3& initialPosition, const char* obstacleFileName = nullptr, std::uint32_t seed = 0);
+
+    // Shares assets loaded once, e.g. by many Scenes running concurrently
+    Scene(std::shared_ptr<const SceneAssets> assets, const Cartesian3& initialPosition, std::uint32_t seed = 0);
 
     // timeStep is measured in meters/seconds to streamline calculations
     // Note: float allows for fractions of seconds
     void update(float timeStep);
 
-    void render();
+    // Copies the state needed by render into snapshot, reusing its storage
+    void captureSnapshot(SceneSnapshot& snapshot) const;
+
+    // Fills record in place, e.g. a slot of a TelemetryPublisher's shared memory ring
+    void captureTelemetry(TelemetryRecord& record) const;
+
+    // Renders snapshot, which may be captured from another thread's Scene::update
+    // Only touches the static parts of the Scene otherwise, i.e. terrain, models & obstacles
+    // Positions are interpolated from the previous tick's (alpha = 0) to the snapshot's (alpha = 1)
+    void render(const SceneSnapshot& snapshot, float alpha = 1.0f);
+
+    // Applies a single control command
+    void applyControl(ControlInput control);
+
+    // Spawns count lava bombs from the volcano at once, regardless of lavaBombBudget
+    void spawnLavaBombs(unsigned int count);
+
+    unsigned int liveLavaBombs() const;
+
+    // Adds count aircraft over random points of the terrain, flying in random directions and circles
+    // Draws from the scene's generator, so scenes with the same seed add the same aircraft
+    void spawnAircraft(unsigned int count);
+
+#ifdef ENABLE_PHASE_TIMING
+    // Writes updatePhaseTimings & renderPhaseTimings as CSV, see writePhaseCsvRows
+    // returns true on success, false otherwise
+    bool writePhaseTimingsFile(const char* fileName) const;
+#endif
+
+    // Footprint of every buffer owned by the scene, shared assets included
+    MemoryReport memoryReport() const;
+
+    // Writes the dynamic state of the scene into state, replacing it, so that restoring it later resumes the flight
+    // exactly where it was saved. Assets are left out, states only restore into scenes sharing the same ones
+    void saveState(std::vector<std::uint8_t>& state) const;
+
+    // Restores a state written by saveState, by this scene or another
+    // returns true on success, false if state is malformed or of another version, leaving the scene unchanged
+    bool restoreState(const std::vector<std::uint8_t>& state);
+
+    // Hash of the dynamic state, for checking that two runs stay identical tick by tick
+    std::uint32_t stateHash() const;
 
     // Rotate plane theta° around x-axis CW
     void pitchUp();
@@ -62,13 +299,43 @@ public:
 
 private:
     Cartesian3 planePosition;
+    // Translation applied by the latest movePlane, the plane swept along it during the tick
+    Cartesian3 planeTranslation;
     Matrix4 planeRotation;
     Speed flightSpeed;
+    // Sorted by id, since lava bombs are appended in spawn order and erasing preserves order
     std::vector<LavaBombParticle> lavaBombs;
+    LavaBombId nextLavaBombId;
     // Measured in seconds, this allows to compute it as sum of timeSteps
     float chronometer;
+    // Measured in seconds, total time simulated so far
+    // Double precision, as it keeps growing and landing events are compared against it tick by tick
+    double simulationTime;
+
+    // Owned by the scene, so that scenes on different threads neither share nor contend for one
+    Random random;
 
-    std::vector<Cartesian3> lavaBombCollisionPoints;
+    // As many as lavaBombs once refreshLavaBombs is done, see LavaBombLanding
+    LavaBombLandingQueue lavaBombLandings;
+
+    // Positions of lavaBombs as of the latest updateLavaBombs, in the same order, for batch collisions
+    PointBatch lavaBombPositions;
+    // Scratch space for the indices reported by batch collisions, lavaBombCollisionParts slices of one per lava bomb
+    std::vector<std::uint32_t> lavaBombCollisionHits;
+    // Scratch space for the indices reported by checkPlaneCollision, apart so that it runs alongside lava bombs
+    std::vector<std::uint32_t> planeCollisionHits;
+
+    // Scratch space for a single update, e.g. explosion points & velocities of lava bomb bursts
+    FrameArena frameArena;
+
+    // One task per UpdatePhase, in the same order, declaring the SceneData each of them reads & writes
+    TaskGraph updateGraph;
+    // timeStep of the running update, for the tasks of updateGraph
+    float updateTimeStep;
+
+    // Most lavaBombs & lavaBombLandings at once, for memory reports
+    std::size_t peakLavaBombs;
+    std::size_t peakLavaBombLandings;
 
     // Returns C^(-1) derived from planePosition & planeRotation
     // C^(-1) = (T * R)^-1 = R^(-1) * T^(-1) = R^T * (-T)
@@ -76,26 +343,63 @@ private:
     // T = Matrix4::Translate(cameraPosition)
     Matrix4 inverseCameraMatrix;
 
+    // Clears the frame and sets up lighting & materials for snapshot's plane orientation
+    void prepareRender(const SceneSnapshot& snapshot);
+
     // Called on every Render()
-    void updateCameraMatrix();
+    void updateCameraMatrix(const SceneSnapshot& snapshot, float alpha);
 
     Matrix4 computeViewMatrix(const Cartesian3& position) const;
 
+    // Adds the phases of update to updateGraph
+    void buildUpdateGraph();
+
     // Move plane in the forward direction times flightSpeed
     void movePlane();
 
+    void moveAircraft();
+
     void updateLavaBombs(float timeStep);
 
+    // Kill lava bombs whose landing time has been reached
+    void retireLandedLavaBombs();
+
+    // Spawns count lava bombs from position, drawing their velocities in a single batch
+    void spawnLavaBombBurst(const Cartesian3& position, unsigned int count);
+
+    // Refresh lavaBombPositions & lavaBombCollisionHits from lavaBombs
+    void gatherLavaBombPositions();
+
+    // Erase dead lava bombs, then spawn explosions from where they died & new lava bombs from the volcano
     void refreshLavaBombs();
 
+    // Drops the events of lava bombs no longer in lavaBombs, i.e. those erased after colliding
+    void dropStaleLavaBombLandings();
+
+    // Reserves every lava bomb buffer, frameArena included, for lavaBombBudget
+    // So that update stops allocating after warm-up, at least until the budget grows
+    void reserveLavaBombCapacity();
+
+    void updatePeakSizes();
+
     void checkPlaneCollision();
 
-    void checkLavaBombCollisions();
+    // Ends the flight, keeping the cause of the first crash
+    void crash(CrashCause cause);
+
+    void checkAircraftCollisions();
+
+    // Checks the lava bombs of parts [firstPart, endPart) out of lavaBombCollisionParts equal slices of lavaBombs
+    void checkLavaBombCollisions(std::size_t firstPart, std::size_t endPart);
 
     // Must be called after updateCameraMatrix()
-    void renderTerrain() const;
+    void renderTerrain();
+
+    void renderLavaBombs(const SceneSnapshot& snapshot, float alpha);
+
+    void renderObstacles();
 
-    void renderLavaBombs();
+    void renderAircraft(const SceneSnapshot& snapshot, float alpha);
 };
 
 #endif
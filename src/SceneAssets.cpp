@@ -0,0 +1,96 @@
+#include "SceneAssets.h"
+
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <thread>
+
+#include "TraceEvents.h"
+
+const std::array<const char*, loadStepCount> loadStepNames = {
+    "terrain",
+    "planeModel",
+    "lavaBombModel",
+    "obstacles",
+};
+
+// three local variables with the hardcoded file names
+const std::string terrainName = "assets/landscape.dem";
+const std::string planeModelName = "assets/planeModel.tri";
+const std::string lavaBombModelName = "assets/lavaBombModel.tri";
+
+// Runs load, storing its duration as step's load time
+template <typename Load>
+void timeLoadStep(std::array<double, loadStepCount>& loadTimes, const LoadStep step, Load load) {
+    const auto start = std::chrono::steady_clock::now();
+    load();
+    const auto duration = std::chrono::steady_clock::now() - start;
+    loadTimes[static_cast<std::size_t>(step)] = std::chrono::duration<double, std::milli>(duration).count();
+}
+
+SceneAssets::SceneAssets(const char* obstacleFileName) {
+    TRACE_SCOPE("load", "loadSceneAssets");
+    const auto start = std::chrono::steady_clock::now();
+
+    // Each thread writes to its own asset and load time only
+    // Loader threads are named only while tracing, as naming registers a trace buffer
+    std::thread terrainLoader([this] {
+        if (isTracing()) {
+            setTraceThreadName("terrainLoader");
+        }
+        timeLoadStep(loadTimes, LoadStep::Terrain, [this] {
+            terrain.readTerrainFile(terrainName.data(), 500);
+        });
+    });
+    std::thread lavaBombModelLoader([this] {
+        if (isTracing()) {
+            setTraceThreadName("lavaBombModelLoader");
+        }
+        timeLoadStep(loadTimes, LoadStep::LavaBombModel, [this] {
+            lavaBombModel.readTriangleSoupFile(lavaBombModelName.data());
+        });
+    });
+
+    timeLoadStep(loadTimes, LoadStep::PlaneModel, [this] {
+        planeModel.readTriangleSoupFile(planeModelName.data());
+    });
+    bool obstaclesRead = true;
+    timeLoadStep(loadTimes, LoadStep::Obstacles, [&] {
+        obstaclesRead = obstacleFileName == nullptr || obstacles.readObstacleFile(obstacleFileName);
+    });
+
+    // Joined before throwing, as the loaders write to this
+    terrainLoader.join();
+    lavaBombModelLoader.join();
+
+    const auto duration = std::chrono::steady_clock::now() - start;
+    totalLoadTime = std::chrono::duration<double, std::milli>(duration).count();
+
+    if (!obstaclesRead) {
+        throw std::string("Unable to read obstacle file ") + obstacleFileName;
+    }
+}
+
+void SceneAssets::printLoadTimes(std::ostream& stream) const {
+    const std::ios::fmtflags flags = stream.flags();
+    const std::streamsize precision = stream.precision();
+
+    stream << std::fixed << std::setprecision(3);
+    for (std::size_t step = 0; step < loadStepCount; step++) {
+        stream << "  " << std::left << std::setw(18) << loadStepNames[step] << std::right << loadTimes[step] << " ms"
+               << std::endl;
+    }
+    stream << "  " << std::left << std::setw(18) << "total" << std::right << totalLoadTime << " ms" << std::endl;
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+MemoryReport SceneAssets::memoryReport() const {
+    MemoryReport report;
+    report.add("terrain.", terrain.memoryReport());
+    report.add("planeModel.", planeModel.memoryReport());
+    report.add("lavaBombModel.", lavaBombModel.memoryReport());
+    report.add("obstacles.", obstacles.memoryReport());
+    return report;
+}
@@ -0,0 +1,49 @@
+#ifndef SCENE_ASSETS
+#define SCENE_ASSETS
+
+#include <array>
+#include <cstddef>
+#include <ostream>
+
+#include "HomogeneousFaceSurface.h"
+#include "MemoryReport.h"
+#include "ObstacleLayer.h"
+#include "Terrain.h"
+
+// Steps of loading SceneAssets, timed separately
+enum class LoadStep {
+    Terrain,
+    PlaneModel,
+    LavaBombModel,
+    Obstacles,
+};
+
+constexpr std::size_t loadStepCount = 4;
+
+extern const std::array<const char*, loadStepCount> loadStepNames;
+
+// Static parts of a Scene, loaded once and shared read-only by every Scene built from them
+// Nothing modifies them after loading, so Scenes on different threads may share them without locking
+struct SceneAssets {
+    Terrain terrain;
+    HomogeneousFaceSurface planeModel;
+    HomogeneousFaceSurface lavaBombModel;
+    ObstacleLayer obstacles;
+
+    // Measured in milliseconds, per LoadStep, the steps overlap
+    std::array<double, loadStepCount> loadTimes{};
+    // Measured in milliseconds, from the start of the first step to the end of the last
+    double totalLoadTime = 0.0;
+
+    // Loads the terrain & models, and obstacleFileName's obstacles unless null
+    // The terrain and the lava bomb model load on threads of their own, alongside the others
+    // Throws a std::string if the obstacles can't be read
+    explicit SceneAssets(const char* obstacleFileName = nullptr);
+
+    // Writes a line per LoadStep, then the total
+    void printLoadTimes(std::ostream& stream) const;
+
+    MemoryReport memoryReport() const;
+};
+
+#endif
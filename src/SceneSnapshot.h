@@ -0,0 +1,37 @@
+#ifndef SCENE_SNAPSHOT
+#define SCENE_SNAPSHOT
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "Cartesian3.h"
+#include "Matrix4.h"
+
+// State of a Scene needed to render it, captured after a simulation tick
+// Positions are also kept as of the previous tick, so that renderers can interpolate between both
+struct SceneSnapshot {
+    unsigned long tick = 0;
+    // Real time the tick stands for, and the simulated time since the previous one, in seconds
+    std::chrono::steady_clock::time_point tickTime;
+    float timeStep = 0.0f;
+    // Key presses applied as of this tick, and when the latest of them was received, see HeldControls
+    unsigned long appliedPresses = 0;
+    std::chrono::steady_clock::time_point latestPressTime;
+
+    Cartesian3 planePosition;
+    Cartesian3 previousPlanePosition;
+    Matrix4 planeRotation;
+    // Identify entities across snapshots, see LavaBombId & AircraftId, in the same order as their positions
+    std::vector<std::uint32_t> lavaBombIds;
+    std::vector<std::uint32_t> aircraftIds;
+    std::vector<Cartesian3> lavaBombPositions;
+    std::vector<Cartesian3> previousLavaBombPositions;
+    std::vector<Cartesian3> aircraftPositions;
+    std::vector<Cartesian3> previousAircraftPositions;
+    // Horizontal unit vectors, see AircraftStore::headingRotation
+    std::vector<Cartesian3> aircraftHeadings;
+    bool shouldExit = false;
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "SceneState.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "StateSync.h"
+
+// Shortest run copied from the previous state, shorter ones are cheaper as literals
+constexpr std::size_t minimumCopyLength = 8;
+
+// Bytes skipped past changed bytes before looking for a moved run again, runs found are extended backwards,
+// so only runs shorter than probeStride + minimumCopyLength may be missed
+constexpr std::size_t probeStride = 4 * stateAlignment;
+
+std::uint64_t loadWord(const std::uint8_t* bytes) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+std::size_t wordHash(const std::uint64_t word, const int bits) {
+    return static_cast<std::size_t>((word * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+}
+
+void encodeStateDelta(const std::vector<std::uint8_t>& previous, const std::vector<std::uint8_t>& current,
+                      std::vector<std::uint8_t>& delta) {
+    delta.clear();
+    ByteWriter writer(delta);
+    writer.writeVarint(current.size());
+
+    // Where words of previous start, plus one, values only ever move by multiples of stateAlignment
+    // Reused between calls, states keep about the same size
+    thread_local std::vector<std::uint32_t> positions;
+    int bits = 10;
+    while ((std::size_t(1) << bits) < previous.size() / stateAlignment) {
+        bits++;
+    }
+    positions.assign(std::size_t(1) << bits, 0);
+    for (std::size_t i = 0; i + minimumCopyLength <= previous.size(); i += stateAlignment) {
+        positions[wordHash(loadWord(&previous[i]), bits)] = static_cast<std::uint32_t>(i + 1);
+    }
+
+    const std::size_t size = current.size();
+    std::size_t literalStart = 0;
+    // Where the bytes at i came from in previous, if they were not removed nor moved
+    std::size_t expectedSource = 0;
+    std::size_t i = 0;
+    while (i + minimumCopyLength <= size) {
+        const std::uint64_t word = loadWord(&current[i]);
+
+        // Unchanged bytes stay in place, moved ones are looked up
+        std::size_t source = expectedSource;
+        if (source + minimumCopyLength > previous.size() || loadWord(&previous[source]) != word) {
+            source = positions[wordHash(word, bits)];
+            if (source == 0 || loadWord(&previous[source - 1]) != word) {
+                i += probeStride;
+                expectedSource += probeStride;
+                continue;
+            }
+            source--;
+        }
+
+        // The run may start before the probed word, back into the literals since the previous run
+        while (i >= literalStart + stateAlignment && source >= stateAlignment &&
+               std::memcmp(&current[i - stateAlignment], &previous[source - stateAlignment], stateAlignment) == 0) {
+            i -= stateAlignment;
+            source -= stateAlignment;
+        }
+
+        // Whole aligned values, so that i stays aligned, compared a word at a time while both have one left
+        std::size_t length = minimumCopyLength;
+        while (i + length + sizeof(std::uint64_t) <= size && source + length + sizeof(std::uint64_t) <= previous.size() &&
+               loadWord(&current[i + length]) == loadWord(&previous[source + length])) {
+            length += sizeof(std::uint64_t);
+        }
+        while (i + length + stateAlignment <= size && source + length + stateAlignment <= previous.size() &&
+               std::memcmp(&current[i + length], &previous[source + length], stateAlignment) == 0) {
+            length += stateAlignment;
+        }
+
+        writer.writeVarint(i - literalStart);
+        delta.insert(delta.end(), current.begin() + literalStart, current.begin() + i);
+        writer.writeVarint(length);
+        writer.writeSigned(static_cast<std::int64_t>(source) - static_cast<std::int64_t>(expectedSource));
+
+        i += length;
+        literalStart = i;
+        expectedSource = source + length;
+    }
+
+    if (literalStart < size) {
+        writer.writeVarint(size - literalStart);
+        delta.insert(delta.end(), current.begin() + literalStart, current.end());
+        writer.writeVarint(0);
+        writer.writeSigned(0);
+    }
+}
+
+bool decodeStateDelta(const std::vector<std::uint8_t>& previous, const std::vector<std::uint8_t>& delta,
+                      std::vector<std::uint8_t>& current) {
+    ByteReader reader(delta.data(), delta.size());
+
+    std::uint64_t size = 0;
+    if (!reader.readVarint(size)) {
+        return false;
+    }
+    // Grown along with the runs read, rather than trusting size upfront
+    current.clear();
+
+    std::size_t i = 0;
+    std::size_t copySource = 0;
+    while (i < size) {
+        std::uint64_t literals = 0;
+        std::uint64_t length = 0;
+        std::int64_t sourceOffset = 0;
+        if (!reader.readVarint(literals) || literals > size - i ||
+            literals > static_cast<std::size_t>(reader.end - reader.position)) {
+            return false;
+        }
+        current.insert(current.end(), reader.position, reader.position + literals);
+        reader.position += literals;
+        i += literals;
+        copySource += literals;
+
+        if (!reader.readVarint(length) || !reader.readSigned(sourceOffset) || length > size - i ||
+            (literals == 0 && length == 0)) {
+            return false;
+        }
+        if (length == 0) {
+            continue;
+        }
+        const std::int64_t source = static_cast<std::int64_t>(copySource) + sourceOffset;
+        if (source < 0 || static_cast<std::uint64_t>(source) > previous.size() ||
+            length > previous.size() - static_cast<std::size_t>(source)) {
+            return false;
+        }
+        current.insert(current.end(), previous.begin() + source, previous.begin() + source + length);
+        i += length;
+        copySource = static_cast<std::size_t>(source) + length;
+    }
+
+    return reader.position == reader.end;
+}
+
+bool writeSceneStateFile(const char* fileName, const std::vector<std::uint8_t>& state) {
+    std::ofstream outFile(fileName, std::ios::binary);
+    outFile.write(reinterpret_cast<const char*>(state.data()), static_cast<std::streamsize>(state.size()));
+    return outFile.good();
+}
+
+bool readSceneStateFile(const char* fileName, std::vector<std::uint8_t>& state) {
+    std::ifstream inFile(fileName, std::ios::binary);
+    if (!inFile.good()) {
+        return false;
+    }
+    state.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+    return !inFile.bad();
+}
@@ -0,0 +1,131 @@
+#ifndef SCENE_STATE
+#define SCENE_STATE
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// First bytes of every state written by Scene::saveState, "BFSS" in little-endian order
+constexpr std::uint32_t sceneStateMagic = 0x53534642;
+
+// Bumped whenever the layout written by Scene::saveState changes, states of other versions are rejected
+constexpr std::uint32_t sceneStateVersion = 2;
+
+// Every value and array is padded to a multiple of stateAlignment bytes, so that values stay aligned in a state
+// however the arrays before them grow or shrink, which lets deltas look for moved values at aligned offsets only
+constexpr std::size_t stateAlignment = 4;
+
+constexpr std::size_t alignedStateSize(const std::size_t size) {
+    return (size + stateAlignment - 1) / stateAlignment * stateAlignment;
+}
+
+// Appends values to a saved state as their raw bytes, in the byte order of the machine
+// States are meant to be restored on the machine, or at least the kind of machine, that saved them
+class StateWriter {
+public:
+    std::vector<std::uint8_t>& bytes;
+
+    explicit StateWriter(std::vector<std::uint8_t>& bytes)
+        : bytes(bytes) {
+    }
+
+    // Grows the state by size bytes plus zeroed padding, returns where they start, to fill before any other write
+    std::uint8_t* append(const std::size_t size) {
+        const std::size_t offset = bytes.size();
+        bytes.resize(offset + alignedStateSize(size));
+        return bytes.data() + offset;
+    }
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Saved states hold raw bytes");
+        std::memcpy(append(sizeof(T)), &value, sizeof(T));
+    }
+
+    // Element count, then the elements back to back
+    template <typename T>
+    void writeArray(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "Saved states hold raw bytes");
+        write(static_cast<std::uint32_t>(values.size()));
+        std::uint8_t* destination = append(values.size() * sizeof(T));
+        if (!values.empty()) {
+            std::memcpy(destination, values.data(), values.size() * sizeof(T));
+        }
+    }
+};
+
+// Reads values written by a StateWriter, every read returns false once past the end
+class StateReader {
+public:
+    const std::uint8_t* position;
+    const std::uint8_t* end;
+
+    StateReader(const std::uint8_t* data, std::size_t size)
+        : position(data),
+          end(data + size) {
+    }
+
+    // Skips size bytes and their padding, returns where they start, or nullptr if the state ends before them
+    const std::uint8_t* take(const std::size_t size) {
+        if (static_cast<std::size_t>(end - position) < alignedStateSize(size)) {
+            return nullptr;
+        }
+        const std::uint8_t* start = position;
+        position += alignedStateSize(size);
+        return start;
+    }
+
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Saved states hold raw bytes");
+        const std::uint8_t* source = take(sizeof(T));
+        if (!source) {
+            return false;
+        }
+        std::memcpy(&value, source, sizeof(T));
+        return true;
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& values) {
+        std::uint32_t count = 0;
+        if (!read(count) || static_cast<std::size_t>(end - position) / sizeof(T) < count) {
+            return false;
+        }
+        const std::uint8_t* source = take(count * sizeof(T));
+        if (!source) {
+            return false;
+        }
+        values.resize(count);
+        if (count > 0) {
+            std::memcpy(values.data(), source, count * sizeof(T));
+        }
+        return true;
+    }
+
+    bool atEnd() const {
+        return position == end;
+    }
+};
+
+// Encodes current as runs of bytes copied from previous and the bytes in between, replacing delta
+// Runs are found where they were in previous, or wherever they moved to, e.g. after elements were erased from
+// an array, so consecutive states of a scene compress to about the values that changed between them
+void encodeStateDelta(const std::vector<std::uint8_t>& previous, const std::vector<std::uint8_t>& current,
+                      std::vector<std::uint8_t>& delta);
+
+// Rebuilds the state delta was encoded from against previous, replacing current
+// returns true on success, false if delta is malformed
+bool decodeStateDelta(const std::vector<std::uint8_t>& previous, const std::vector<std::uint8_t>& delta,
+                      std::vector<std::uint8_t>& current);
+
+// returns true on success, false otherwise
+bool writeSceneStateFile(const char* fileName, const std::vector<std::uint8_t>& state);
+
+// Reads a state written by writeSceneStateFile, replacing state
+// returns true on success, false otherwise
+bool readSceneStateFile(const char* fileName, std::vector<std::uint8_t>& state);
+
+#endif
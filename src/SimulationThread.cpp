@@ -0,0 +1,237 @@
+#include "SimulationThread.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "TraceEvents.h"
+
+typedef std::chrono::steady_clock Clock;
+
+SimulationThread::SimulationThread(Scene& scene, const float timeStep)
+    : scene(scene),
+      timeStep(timeStep),
+      running(false),
+      updateCost(0.0f),
+      recorder(nullptr),
+      inputReplay(nullptr),
+      telemetry(nullptr),
+      divergenceTick(0) {
+    // Renderers may read before the first tick
+    publishSnapshot(Clock::now());
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::record(InputRecorder& recorder) {
+    this->recorder = &recorder;
+}
+
+void SimulationThread::replay(InputReplay& replay) {
+    inputReplay = &replay;
+}
+
+void SimulationThread::publishTelemetry(TelemetryPublisher& publisher) {
+    telemetry = &publisher;
+}
+
+void SimulationThread::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    thread = std::thread(inputReplay ? &SimulationThread::runReplay : &SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool SimulationThread::pushControl(const ControlInput control) {
+    return controls.push(control);
+}
+
+bool SimulationThread::pressControl(const ControlInput control) {
+    HeldControlEvent event;
+    event.action = HeldControlAction::Press;
+    event.control = control;
+    event.time = Clock::now();
+    return heldControlEvents.push(event);
+}
+
+bool SimulationThread::releaseControl(const ControlInput control) {
+    HeldControlEvent event;
+    event.action = HeldControlAction::Release;
+    event.control = control;
+    event.time = Clock::now();
+    return heldControlEvents.push(event);
+}
+
+bool SimulationThread::releaseAllControls() {
+    HeldControlEvent event;
+    event.action = HeldControlAction::ReleaseAll;
+    event.time = Clock::now();
+    return heldControlEvents.push(event);
+}
+
+bool SimulationThread::pushLavaBombBudget(const LavaBombBudget& budget) {
+    return lavaBombBudgets.push(budget);
+}
+
+const SceneSnapshot& SimulationThread::latestSnapshot() {
+    return snapshots.front();
+}
+
+float SimulationThread::latestUpdateCost() const {
+    return updateCost.load(std::memory_order_relaxed);
+}
+
+const UpdatePhaseSummaries& SimulationThread::latestUpdatePhaseSummaries() {
+    return updatePhaseSummaries.front();
+}
+
+void SimulationThread::run() {
+    setTraceThreadName("simulation");
+
+    const auto tickPeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(timeStep));
+
+    Clock::time_point previousWakeUp = Clock::now();
+    Clock::duration accumulator = Clock::duration::zero();
+
+    // Nothing left to simulate once the scene asks to exit, its last snapshot tells renderers so
+    while (running.load(std::memory_order_relaxed) && !scene.shouldExit) {
+        const Clock::time_point now = Clock::now();
+        accumulator += now - previousWakeUp;
+        previousWakeUp = now;
+
+        // After a stall, catching up on every tick would only stall further
+        accumulator = std::min(accumulator, maximumCatchUpTicks * tickPeriod);
+
+        while (accumulator >= tickPeriod && !scene.shouldExit) {
+            accumulator -= tickPeriod;
+            // The remaining accumulated time is how long ago this tick should have happened
+            tick(now - accumulator);
+        }
+
+        std::this_thread::sleep_until(now + (tickPeriod - accumulator));
+    }
+}
+
+void SimulationThread::runReplay() {
+    setTraceThreadName("simulation");
+
+    // As fast as possible, renderers show whichever tick is latest
+    while (running.load(std::memory_order_relaxed) && !scene.shouldExit && !inputReplay->finished(scene)) {
+        tick(Clock::now());
+    }
+
+    reportReplay();
+
+    // Renderers close once told to exit
+    if (!scene.shouldExit) {
+        scene.shouldExit = true;
+        publishSnapshot(Clock::now());
+    }
+}
+
+void SimulationThread::applyInputs() {
+    ControlInput control;
+    LavaBombBudget budget;
+    HeldControlEvent event;
+
+    if (inputReplay) {
+        // Live inputs would make the run diverge from the recording
+        while (controls.pop(control)) {
+        }
+        while (lavaBombBudgets.pop(budget)) {
+        }
+        while (heldControlEvents.pop(event)) {
+        }
+        inputReplay->applyDue(scene);
+        return;
+    }
+
+    while (controls.pop(control)) {
+        applyControl(control);
+    }
+
+    // Recorded like any other control, so that replays need not know which keys were held
+    while (heldControlEvents.pop(event)) {
+        heldControls.handle(event);
+    }
+    std::array<ControlInput, controlInputCount> dueControls;
+    const std::size_t nDue = heldControls.due(dueControls.data());
+    for (std::size_t i = 0; i < nDue; i++) {
+        applyControl(dueControls[i]);
+    }
+
+    while (lavaBombBudgets.pop(budget)) {
+        scene.lavaBombBudget = budget;
+        if (recorder) {
+            recorder->recordLavaBombBudget(scene.ticks, budget);
+        }
+    }
+}
+
+void SimulationThread::applyControl(const ControlInput control) {
+    scene.applyControl(control);
+    if (recorder) {
+        recorder->recordControl(scene.ticks, control);
+    }
+}
+
+void SimulationThread::reportReplay() const {
+    if (divergenceTick == 0) {
+        std::cout << "Replay matched the recording on all " << inputReplay->verifiedTicks() << " ticks" << std::endl;
+    } else {
+        std::cout << "Replay diverged from the recording at tick " << divergenceTick << std::endl;
+    }
+}
+
+void SimulationThread::tick(const Clock::time_point tickTime) {
+    TRACE_SCOPE("simulation", "tick");
+
+    applyInputs();
+
+    const Clock::time_point updateStart = Clock::now();
+    scene.update(timeStep);
+    updateCost.store(std::chrono::duration<float, std::milli>(Clock::now() - updateStart).count(),
+                     std::memory_order_relaxed);
+
+    if constexpr (phaseTimingEnabled) {
+        if (scene.ticks % ticksPerPhaseSummary == 0) {
+            UpdatePhaseSummaries& summaries = updatePhaseSummaries.back();
+            for (std::size_t phase = 0; phase < updatePhaseCount; phase++) {
+                summaries[phase] = scene.updatePhaseTimings.summarize(phase);
+            }
+            updatePhaseSummaries.publish();
+        }
+    }
+
+    if (telemetry) {
+        scene.captureTelemetry(telemetry->back());
+        telemetry->publish();
+    }
+
+    if (recorder) {
+        recorder->recordStateHash(scene.ticks, scene.stateHash());
+    }
+    if (inputReplay && !inputReplay->verify(scene) && divergenceTick == 0) {
+        divergenceTick = scene.ticks;
+    }
+
+    publishSnapshot(tickTime);
+}
+
+void SimulationThread::publishSnapshot(const Clock::time_point tickTime) {
+    SceneSnapshot& snapshot = snapshots.back();
+    scene.captureSnapshot(snapshot);
+    snapshot.tickTime = tickTime;
+    snapshot.timeStep = timeStep;
+    snapshot.appliedPresses = heldControls.appliedPresses;
+    snapshot.latestPressTime = heldControls.latestPressTime;
+    snapshots.publish();
+}
@@ -0,0 +1,127 @@
+#ifndef SIMULATION_THREAD
+#define SIMULATION_THREAD
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "ControlInput.h"
+#include "HeldControls.h"
+#include "InputRecording.h"
+#include "LockFreeQueue.h"
+#include "PhaseTimer.h"
+#include "Scene.h"
+#include "SceneSnapshot.h"
+#include "TelemetryRing.h"
+#include "TripleBuffer.h"
+
+// Measured in seconds, simulated time per tick at 60 Hz
+constexpr float simulationTimeStep = 1.0f / 60.0f;
+
+// Ticks between refreshes of the update phase statistics handed to other threads
+constexpr unsigned long ticksPerPhaseSummary = 30;
+
+typedef std::array<PhaseSummary, updatePhaseCount> UpdatePhaseSummaries;
+
+// Ticks the simulation may run back to back to catch up after a stall, beyond which time is dropped
+constexpr int maximumCatchUpTicks = 5;
+
+// Runs Scene::update on a dedicated thread at a fixed tick rate, decoupled from rendering
+// Real time elapsed is accumulated on a monotonic clock and consumed in fixed ticks, zero or more per wake-up
+// Other threads never touch the Scene's dynamic state: inputs flow in through lock-free queues
+// and the state to render flows out through a triple-buffered snapshot
+class SimulationThread {
+public:
+    // timeStep is measured in seconds, both simulated per tick and elapsed in real time between ticks
+    explicit SimulationThread(Scene& scene, float timeStep = simulationTimeStep);
+
+    // Stops the thread
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+
+    SimulationThread& operator =(const SimulationThread&) = delete;
+
+    // Both are set before start, and outlive the thread
+    // Logs every input applied, and the state hash after every tick
+    void record(InputRecorder& recorder);
+
+    // Takes inputs from replay instead of the queues, ticking as fast as possible until it runs out of them
+    void replay(InputReplay& replay);
+
+    // Set before start, and outlives the thread
+    // Publishes a TelemetryRecord after every tick, outside of Scene::update
+    void publishTelemetry(TelemetryPublisher& publisher);
+
+    void start();
+
+    void stop();
+
+    // Producer side, one thread only, returns false if the input was dropped due to a full queue
+    bool pushControl(ControlInput control);
+
+    // Producer side, one thread only, returns false if the event was dropped due to a full queue
+    // Controls pressed are applied from the next tick on, at a steady rate until released, see HeldControls
+    bool pressControl(ControlInput control);
+
+    bool releaseControl(ControlInput control);
+
+    bool releaseAllControls();
+
+    bool pushLavaBombBudget(const LavaBombBudget& budget);
+
+    // Reader side, one thread only, latest snapshot published by the simulation
+    // It stays valid and unchanged until the next call
+    const SceneSnapshot& latestSnapshot();
+
+    // Measured in milliseconds, cost of the latest Scene::update
+    float latestUpdateCost() const;
+
+    // Reader side, one thread only, rolling statistics of Scene::updatePhaseTimings as of a recent tick
+    // All zeroes unless built with ENABLE_PHASE_TIMING
+    const UpdatePhaseSummaries& latestUpdatePhaseSummaries();
+
+private:
+    Scene& scene;
+    const float timeStep;
+
+    std::thread thread;
+    std::atomic<bool> running;
+
+    LockFreeQueue<ControlInput, 256> controls;
+    LockFreeQueue<LavaBombBudget, 16> lavaBombBudgets;
+    LockFreeQueue<HeldControlEvent, 256> heldControlEvents;
+
+    HeldControls heldControls;
+
+    TripleBuffer<SceneSnapshot> snapshots;
+    TripleBuffer<UpdatePhaseSummaries> updatePhaseSummaries;
+
+    std::atomic<float> updateCost;
+
+    InputRecorder* recorder;
+    InputReplay* inputReplay;
+    TelemetryPublisher* telemetry;
+    // Tick of the first state hash that did not match the recording, or 0
+    unsigned long divergenceTick;
+
+    void run();
+
+    void runReplay();
+
+    // Applies the inputs queued so far, runs a tick and publishes its snapshot
+    // tickTime is the real time the tick stands for
+    void tick(std::chrono::steady_clock::time_point tickTime);
+
+    void applyInputs();
+
+    void applyControl(ControlInput control);
+
+    // Snapshot of the latest tick for renderers to read
+    void publishSnapshot(std::chrono::steady_clock::time_point tickTime);
+
+    void reportReplay() const;
+};
+
+#endif
@@ -1,21 +1,46 @@
 #include "SphereCollision.h"
 
-#include <cmath>
-#include <limits>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-constexpr float FLOAT_EPS = std::numeric_limits<float>::epsilon();
+/*
+ * All tests compare squared distances against squared radii, which avoids square roots entirely.
+ * No epsilon is applied, fine-grained accuracy is not needed for collisions of this scale.
+ *
+ * The batch kernels process 4 points per SSE2 block, falling back to scalar code for the remainder.
+ * Both are branch-free within a block: comparisons produce lane masks instead of branching per point.
+ */
+
+void PointBatch::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+}
+
+void PointBatch::reserve(const std::size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    z.reserve(count);
+}
+
+void PointBatch::push_back(const Cartesian3& point) {
+    x.push_back(point.x);
+    y.push_back(point.y);
+    z.push_back(point.z);
+}
 
-bool isLessOrEqual(const float a, const float b) {
-    // a <= b iff (a < b || a == b) iff (a < b || abs(a - b) < EPS)
-    return a < b || std::abs(a - b) < FLOAT_EPS;
+std::size_t PointBatch::size() const {
+    return x.size();
 }
 
-float distanceBetween(const Cartesian3& p, const Cartesian3& o) {
-    // clang-format off
-    return std::sqrt(std::pow(p.x - o.x, 2.0f) +
-                     std::pow(p.y - o.y, 2.0f) +
-                     std::pow(p.z - o.z, 2.0f));
-    // clang-format on
+PointSpan PointBatch::span() const {
+    return {x.data(), y.data(), z.data(), x.size()};
+}
+
+float squaredDistanceBetween(const Cartesian3& p, const Cartesian3& o) {
+    const Cartesian3 difference = p - o;
+    return difference.dot(difference);
 }
 
 /**
@@ -27,8 +52,8 @@ float distanceBetween(const Cartesian3& p, const Cartesian3& o) {
  *
  * @return whether point is within the sphere = {center, radius}
  */
-bool isSpherePointCollision(const Cartesian3& center, float radius, const Cartesian3& point) {
-    return isLessOrEqual(distanceBetween(point, center), radius);
+bool isSpherePointCollision(const Cartesian3& center, const float radius, const Cartesian3& point) {
+    return squaredDistanceBetween(point, center) <= radius * radius;
 }
 
 /**
@@ -43,6 +68,94 @@ bool isSphereSphereCollision(const Cartesian3& center1,
                              const float radius1,
                              const Cartesian3& center2,
                              const float radius2) {
-    const float distanceBetweenCenters = distanceBetween(center1, center2);
-    return isLessOrEqual(distanceBetweenCenters, radius1 + radius2);
+    const float radii = radius1 + radius2;
+    return squaredDistanceBetween(center1, center2) <= radii * radii;
+}
+
+// 1 if points[i] is within the sphere, 0 otherwise
+inline unsigned int scalarHit(const Cartesian3& center, const float squaredRadius,
+                              const PointSpan& points, const std::size_t i) {
+    const float dx = points.x[i] - center.x;
+    const float dy = points.y[i] - center.y;
+    const float dz = points.z[i] - center.z;
+    return dx * dx + dy * dy + dz * dz <= squaredRadius;
+}
+
+#ifdef __SSE2__
+// Bit l set iff points[i + l] is within the sphere
+inline unsigned int blockHits(const __m128 cx, const __m128 cy, const __m128 cz, const __m128 squaredRadius,
+                              const PointSpan& points, const std::size_t i) {
+    const __m128 dx = _mm_sub_ps(_mm_loadu_ps(points.x + i), cx);
+    const __m128 dy = _mm_sub_ps(_mm_loadu_ps(points.y + i), cy);
+    const __m128 dz = _mm_sub_ps(_mm_loadu_ps(points.z + i), cz);
+    const __m128 squaredDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                                              _mm_mul_ps(dz, dz));
+    return _mm_movemask_ps(_mm_cmple_ps(squaredDistance, squaredRadius));
+}
+#endif
+
+bool anySpherePointCollision(const Cartesian3& center, const float radius, const PointSpan& points) {
+    const float squaredRadius = radius * radius;
+    std::size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128 cx = _mm_set1_ps(center.x);
+    const __m128 cy = _mm_set1_ps(center.y);
+    const __m128 cz = _mm_set1_ps(center.z);
+    const __m128 r2 = _mm_set1_ps(squaredRadius);
+
+    for (; i + 4 <= points.count; i += 4) {
+        if (blockHits(cx, cy, cz, r2, points, i) != 0) {
+            return true;
+        }
+    }
+#endif
+
+    unsigned int hits = 0;
+    for (; i < points.count; i++) {
+        hits |= scalarHit(center, squaredRadius, points, i);
+    }
+    return hits != 0;
+}
+
+bool anySphereSphereCollision(const Cartesian3& center, const float radius, const PointSpan& centers,
+                              const float radii) {
+    // Two spheres collide iff the center of one is within a sphere of both radii around the other
+    return anySpherePointCollision(center, radius + radii, centers);
+}
+
+std::size_t allSpherePointCollisions(const Cartesian3& center, const float radius, const PointSpan& points,
+                                     std::uint32_t* hits) {
+    const float squaredRadius = radius * radius;
+    std::size_t nHits = 0;
+    std::size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128 cx = _mm_set1_ps(center.x);
+    const __m128 cy = _mm_set1_ps(center.y);
+    const __m128 cz = _mm_set1_ps(center.z);
+    const __m128 r2 = _mm_set1_ps(squaredRadius);
+
+    for (; i + 4 <= points.count; i += 4) {
+        const unsigned int mask = blockHits(cx, cy, cz, r2, points, i);
+
+        // Every lane writes its index, but only hits advance the output
+        for (unsigned int lane = 0; lane < 4; lane++) {
+            hits[nHits] = static_cast<std::uint32_t>(i + lane);
+            nHits += (mask >> lane) & 1u;
+        }
+    }
+#endif
+
+    for (; i < points.count; i++) {
+        hits[nHits] = static_cast<std::uint32_t>(i);
+        nHits += scalarHit(center, squaredRadius, points, i);
+    }
+
+    return nHits;
+}
+
+std::size_t allSphereSphereCollisions(const Cartesian3& center, const float radius, const PointSpan& centers,
+                                      const float radii, std::uint32_t* hits) {
+    return allSpherePointCollisions(center, radius + radii, centers, hits);
 }
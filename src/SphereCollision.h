@@ -1,10 +1,54 @@
 #ifndef SPHERE_COLLISION
 #define SPHERE_COLLISION
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 #include "Cartesian3.h"
 
+// Read-only view over points laid out as structure-of-arrays, as consumed by the batch collisions
+struct PointSpan {
+    const float* x;
+    const float* y;
+    const float* z;
+    std::size_t count;
+};
+
+// Owning structure-of-arrays storage for points, keeps its capacity when cleared
+class PointBatch {
+public:
+    std::vector<float> x, y, z;
+
+    void clear();
+
+    void reserve(std::size_t count);
+
+    void push_back(const Cartesian3& point);
+
+    std::size_t size() const;
+
+    PointSpan span() const;
+};
+
 bool isSpherePointCollision(const Cartesian3& center, float radius, const Cartesian3& point);
 
 bool isSphereSphereCollision(const Cartesian3& center1, float radius1, const Cartesian3& center2, float radius2);
 
+// Whether any point is within the sphere = {center, radius}, stops at the first block with a hit
+bool anySpherePointCollision(const Cartesian3& center, float radius, const PointSpan& points);
+
+// Whether the sphere = {center, radius} collides with any sphere = {centers[i], radii}
+bool anySphereSphereCollision(const Cartesian3& center, float radius, const PointSpan& centers, float radii);
+
+// Writes the indices of every point within the sphere = {center, radius} into hits, in ascending order
+// hits must have room for points.count indices, returns the number of indices written
+std::size_t allSpherePointCollisions(const Cartesian3& center, float radius, const PointSpan& points,
+                                     std::uint32_t* hits);
+
+// Writes the indices of every sphere = {centers[i], radii} colliding with sphere = {center, radius} into hits
+// hits must have room for centers.count indices, returns the number of indices written
+std::size_t allSphereSphereCollisions(const Cartesian3& center, float radius, const PointSpan& centers, float radii,
+                                      std::uint32_t* hits);
+
 #endif
@@ -0,0 +1,263 @@
+#include "StateSync.h"
+
+#include <cmath>
+
+constexpr float headingUnitsPerRadian = 65536.0f / (2.0f * 3.14159265358979f);
+
+std::int32_t quantizeCoordinate(const float value) {
+    return static_cast<std::int32_t>(std::lround(value / positionQuantum));
+}
+
+EntityState quantizeEntity(const std::uint32_t id, const Cartesian3& position) {
+    return {id, quantizeCoordinate(position.x), quantizeCoordinate(position.y), quantizeCoordinate(position.z), 0};
+}
+
+Cartesian3 EntityState::position() const {
+    return {x * positionQuantum, y * positionQuantum, z * positionQuantum};
+}
+
+Cartesian3 EntityState::headingVector() const {
+    const float angle = heading / headingUnitsPerRadian;
+    // CCW from +y, i.e. towards -x
+    return {-std::sin(angle), std::cos(angle), 0.0f};
+}
+
+void quantizeSnapshot(const SceneSnapshot& snapshot, NetworkSnapshot& world) {
+    world.tick = snapshot.tick;
+
+    world.aircraft.clear();
+    for (std::size_t i = 0; i < snapshot.aircraftIds.size(); i++) {
+        EntityState aircraft = quantizeEntity(snapshot.aircraftIds[i], snapshot.aircraftPositions[i]);
+        const Cartesian3& heading = snapshot.aircraftHeadings[i];
+        // Wraps to [0, 65536), the cast keeps the low 16 bits
+        const long angle = std::lround(std::atan2(-heading.x, heading.y) * headingUnitsPerRadian);
+        aircraft.heading = static_cast<std::uint16_t>(angle & 0xFFFF);
+        world.aircraft.push_back(aircraft);
+    }
+
+    world.lavaBombs.clear();
+    for (std::size_t i = 0; i < snapshot.lavaBombIds.size(); i++) {
+        world.lavaBombs.push_back(quantizeEntity(snapshot.lavaBombIds[i], snapshot.lavaBombPositions[i]));
+    }
+}
+
+void ByteWriter::writeVarint(std::uint64_t value) {
+    while (value >= 0x80) {
+        bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+void ByteWriter::writeSigned(const std::int64_t value) {
+    writeVarint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+void ByteWriter::writeInt64(const std::int64_t value) {
+    for (int byte = 0; byte < 8; byte++) {
+        bytes.push_back(static_cast<std::uint8_t>(static_cast<std::uint64_t>(value) >> (8 * byte)));
+    }
+}
+
+bool ByteReader::readByte(std::uint8_t& value) {
+    if (position == end) {
+        return false;
+    }
+    value = *position++;
+    return true;
+}
+
+bool ByteReader::readVarint(std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        std::uint8_t byte = 0;
+        if (!readByte(byte)) {
+            return false;
+        }
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ByteReader::readSigned(std::int64_t& value) {
+    std::uint64_t encoded = 0;
+    if (!readVarint(encoded)) {
+        return false;
+    }
+    value = static_cast<std::int64_t>(encoded >> 1) ^ -static_cast<std::int64_t>(encoded & 1);
+    return true;
+}
+
+bool ByteReader::readInt64(std::int64_t& value) {
+    if (end - position < 8) {
+        return false;
+    }
+    std::uint64_t bits = 0;
+    for (int byte = 0; byte < 8; byte++) {
+        bits |= static_cast<std::uint64_t>(*position++) << (8 * byte);
+    }
+    value = static_cast<std::int64_t>(bits);
+    return true;
+}
+
+std::int64_t steadyClockNanoseconds() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+// Removed ids, then updated entities, merging current against baseline as both are sorted by id
+void writeEntitySection(ByteWriter& writer, const std::vector<EntityState>& current,
+                        const std::vector<EntityState>& baseline, const bool hasHeading) {
+    const EntityState none;
+
+    // Removed: in baseline, not in current
+    std::size_t nRemoved = 0;
+    for (std::size_t i = 0, j = 0; i < baseline.size(); i++) {
+        while (j < current.size() && current[j].id < baseline[i].id) {
+            j++;
+        }
+        nRemoved += j == current.size() || current[j].id != baseline[i].id;
+    }
+    writer.writeVarint(nRemoved);
+    std::uint32_t previousId = 0;
+    for (std::size_t i = 0, j = 0; i < baseline.size(); i++) {
+        while (j < current.size() && current[j].id < baseline[i].id) {
+            j++;
+        }
+        if (j == current.size() || current[j].id != baseline[i].id) {
+            writer.writeVarint(baseline[i].id - previousId);
+            previousId = baseline[i].id;
+        }
+    }
+
+    // Updated: in current, new or differing from baseline
+    std::size_t nUpdated = 0;
+    for (std::size_t i = 0, j = 0; i < current.size(); i++) {
+        while (j < baseline.size() && baseline[j].id < current[i].id) {
+            j++;
+        }
+        nUpdated += j == baseline.size() || baseline[j] != current[i];
+    }
+    writer.writeVarint(nUpdated);
+    previousId = 0;
+    for (std::size_t i = 0, j = 0; i < current.size(); i++) {
+        while (j < baseline.size() && baseline[j].id < current[i].id) {
+            j++;
+        }
+        const bool isKnown = j < baseline.size() && baseline[j].id == current[i].id;
+        const EntityState& reference = isKnown ? baseline[j] : none;
+        if (isKnown && reference == current[i]) {
+            continue;
+        }
+
+        writer.writeVarint(current[i].id - previousId);
+        previousId = current[i].id;
+        writer.writeSigned(static_cast<std::int64_t>(current[i].x) - reference.x);
+        writer.writeSigned(static_cast<std::int64_t>(current[i].y) - reference.y);
+        writer.writeSigned(static_cast<std::int64_t>(current[i].z) - reference.z);
+        if (hasHeading) {
+            // Wrapped to the shortest way round
+            writer.writeSigned(static_cast<std::int16_t>(current[i].heading - reference.heading));
+        }
+    }
+}
+
+void writeSnapshotMessage(ByteWriter& writer, const NetworkSnapshot& current, const NetworkSnapshot* baseline,
+                          const std::int64_t sendTime) {
+    static const NetworkSnapshot empty;
+
+    writer.writeByte(static_cast<std::uint8_t>(MessageType::Snapshot));
+    writer.writeVarint(current.tick);
+    writer.writeVarint(baseline ? baseline->tick : 0);
+    writer.writeInt64(sendTime);
+
+    const NetworkSnapshot& reference = baseline ? *baseline : empty;
+    writeEntitySection(writer, current.aircraft, reference.aircraft, true);
+    writeEntitySection(writer, current.lavaBombs, reference.lavaBombs, false);
+}
+
+bool readSnapshotHeader(ByteReader& reader, SnapshotHeader& header) {
+    std::uint64_t tick = 0, baselineTick = 0;
+    if (!reader.readVarint(tick) || !reader.readVarint(baselineTick) || !reader.readInt64(header.sendTime)) {
+        return false;
+    }
+    header.tick = tick;
+    header.baselineTick = baselineTick;
+    return true;
+}
+
+bool readEntitySection(ByteReader& reader, const std::vector<EntityState>& baseline,
+                       std::vector<EntityState>& current, const bool hasHeading) {
+    std::uint64_t nRemoved = 0;
+    if (!reader.readVarint(nRemoved) || nRemoved > baseline.size()) {
+        return false;
+    }
+
+    // Baseline entities, minus the removed ones
+    current.clear();
+    std::uint64_t removedId = 0;
+    std::size_t next = 0;
+    for (std::uint64_t removed = 0; removed < nRemoved; removed++) {
+        std::uint64_t increment = 0;
+        if (!reader.readVarint(increment)) {
+            return false;
+        }
+        removedId += increment;
+        while (next < baseline.size() && baseline[next].id < removedId) {
+            current.push_back(baseline[next++]);
+        }
+        if (next == baseline.size() || baseline[next].id != removedId) {
+            return false;
+        }
+        next++;
+    }
+    current.insert(current.end(), baseline.begin() + next, baseline.end());
+
+    std::uint64_t nUpdated = 0;
+    if (!reader.readVarint(nUpdated)) {
+        return false;
+    }
+
+    // Updated entities replace or join the kept ones, merged in id order
+    std::vector<EntityState> kept;
+    kept.swap(current);
+    std::uint64_t updatedId = 0;
+    next = 0;
+    for (std::uint64_t updated = 0; updated < nUpdated; updated++) {
+        std::uint64_t increment = 0;
+        std::int64_t dx = 0, dy = 0, dz = 0, dHeading = 0;
+        if (!reader.readVarint(increment) || !reader.readSigned(dx) || !reader.readSigned(dy) ||
+            !reader.readSigned(dz) || (hasHeading && !reader.readSigned(dHeading))) {
+            return false;
+        }
+        updatedId += increment;
+
+        while (next < kept.size() && kept[next].id < updatedId) {
+            current.push_back(kept[next++]);
+        }
+        EntityState entity;
+        if (next < kept.size() && kept[next].id == updatedId) {
+            entity = kept[next++];
+        }
+        entity.id = static_cast<std::uint32_t>(updatedId);
+        entity.x = static_cast<std::int32_t>(entity.x + dx);
+        entity.y = static_cast<std::int32_t>(entity.y + dy);
+        entity.z = static_cast<std::int32_t>(entity.z + dz);
+        entity.heading = static_cast<std::uint16_t>(entity.heading + dHeading);
+        current.push_back(entity);
+    }
+    current.insert(current.end(), kept.begin() + next, kept.end());
+
+    return true;
+}
+
+bool readSnapshotEntities(ByteReader& reader, const NetworkSnapshot* baseline, NetworkSnapshot& current) {
+    static const NetworkSnapshot empty;
+
+    const NetworkSnapshot& reference = baseline ? *baseline : empty;
+    return readEntitySection(reader, reference.aircraft, current.aircraft, true) &&
+           readEntitySection(reader, reference.lavaBombs, current.lavaBombs, false);
+}
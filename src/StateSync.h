@@ -0,0 +1,139 @@
+#ifndef STATE_SYNC
+#define STATE_SYNC
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Cartesian3.h"
+#include "SceneSnapshot.h"
+
+/*
+ * Messages exchanged by MultiplayerServer and MultiplayerClient over UDP.
+ *
+ * Layout, varints are LEB128 and signed ones zigzag encoded first:
+ *   join      u8 type
+ *   welcome   u8 type, varint client id, varint aircraft id
+ *   input     u8 type, varint client id, varint latest snapshot tick received, zigzag speed, climb rate & turn,
+ *             each in 1/256 of meters/tick or degrees/tick
+ *   snapshot  u8 type, varint tick, varint baseline tick or 0 for none, i64 server send time in nanoseconds,
+ *             then an aircraft section and a lava bomb section, each:
+ *               varint removed count, then varint id increments
+ *               varint updated count, then per entity varint id increment and zigzag field increments
+ * Entities of a snapshot are those of its baseline, minus the removed ones, plus the updated ones, which are either
+ * new or moved. Fields of updated entities are sent as increments from the baseline's, or from 0 if new.
+ */
+
+enum class MessageType : std::uint8_t {
+    Join,
+    Welcome,
+    Input,
+    Snapshot
+};
+
+// Snapshots kept by servers and clients as potential baselines, baselines must be less than this many ticks old
+constexpr std::size_t snapshotHistory = 32;
+
+// Measured in meters, positions are sent as multiples of it
+constexpr float positionQuantum = 1.0f / 16.0f;
+
+// Steering sent by a client for its aircraft, in 1/256 of the units of AircraftStore::steer
+constexpr float steeringQuantum = 1.0f / 256.0f;
+
+// Position, and heading for aircraft, quantized
+struct EntityState {
+    std::uint32_t id = 0;
+    std::int32_t x = 0;
+    std::int32_t y = 0;
+    std::int32_t z = 0;
+    // Angle CCW from +y, 65536 per turn, always 0 for lava bombs
+    std::uint16_t heading = 0;
+
+    bool operator==(const EntityState& other) const {
+        return id == other.id && x == other.x && y == other.y && z == other.z && heading == other.heading;
+    }
+
+    bool operator!=(const EntityState& other) const {
+        return !(*this == other);
+    }
+
+    Cartesian3 position() const;
+
+    // Horizontal unit vector, see AircraftStore::headingRotation
+    Cartesian3 headingVector() const;
+};
+
+// Entities as sent to one client, both sorted by id
+struct NetworkSnapshot {
+    unsigned long tick = 0;
+    std::vector<EntityState> aircraft;
+    std::vector<EntityState> lavaBombs;
+};
+
+// Quantizes every entity of snapshot into world, reusing its storage
+void quantizeSnapshot(const SceneSnapshot& snapshot, NetworkSnapshot& world);
+
+// Appends to a byte buffer
+class ByteWriter {
+public:
+    std::vector<std::uint8_t>& bytes;
+
+    explicit ByteWriter(std::vector<std::uint8_t>& bytes)
+        : bytes(bytes) {
+    }
+
+    void writeByte(std::uint8_t value) {
+        bytes.push_back(value);
+    }
+
+    void writeVarint(std::uint64_t value);
+
+    void writeSigned(std::int64_t value);
+
+    void writeInt64(std::int64_t value);
+};
+
+// Reads from a byte buffer, every read returns false once past its end
+class ByteReader {
+public:
+    const std::uint8_t* position;
+    const std::uint8_t* end;
+
+    ByteReader(const std::uint8_t* data, std::size_t size)
+        : position(data),
+          end(data + size) {
+    }
+
+    bool readByte(std::uint8_t& value);
+
+    bool readVarint(std::uint64_t& value);
+
+    bool readSigned(std::int64_t& value);
+
+    bool readInt64(std::int64_t& value);
+};
+
+// Nanoseconds of the steady clock, comparable between processes of the same machine
+std::int64_t steadyClockNanoseconds();
+
+// Writes a snapshot message of current, as increments from baseline unless null
+void writeSnapshotMessage(ByteWriter& writer, const NetworkSnapshot& current, const NetworkSnapshot* baseline,
+                          std::int64_t sendTime);
+
+struct SnapshotHeader {
+    unsigned long tick = 0;
+    // 0 if the snapshot is sent in full
+    unsigned long baselineTick = 0;
+    std::int64_t sendTime = 0;
+};
+
+// Reads the header of a snapshot message, after its type
+bool readSnapshotHeader(ByteReader& reader, SnapshotHeader& header);
+
+// Reads the entities of a snapshot message, after its header, into current
+// baseline is the snapshot named by the header, null if it has none
+// returns true on success, false if the message is malformed
+bool readSnapshotEntities(ByteReader& reader, const NetworkSnapshot* baseline, NetworkSnapshot& current);
+
+#endif
@@ -0,0 +1,275 @@
+#include "TaskGraph.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "PhaseTimer.h"
+
+// Declared accesses of the task part running on this thread, if any
+thread_local bool runningTask = false;
+thread_local const char* runningTaskName = nullptr;
+thread_local AccessSet runningReads = 0;
+thread_local AccessSet runningWrites = 0;
+thread_local const std::vector<const char*>* runningDataNames = nullptr;
+
+// Data which a & b both access, either of them writing it
+AccessSet conflictingData(const AccessSet readsA, const AccessSet writesA, const AccessSet readsB,
+                          const AccessSet writesB) {
+    return (writesA & (readsB | writesB)) | (writesB & readsA);
+}
+
+// Names of the data in set, separated by commas
+std::string describeData(const AccessSet set, const std::vector<const char*>& dataNames) {
+    std::string description;
+    for (std::size_t bit = 0; bit < dataNames.size(); bit++) {
+        if (set & (AccessSet(1) << bit)) {
+            if (!description.empty()) {
+                description += ", ";
+            }
+            description += dataNames[bit];
+        }
+    }
+    return description;
+}
+
+void checkTaskAccess(const AccessSet reads, const AccessSet writes, const char* scope) {
+    if (!runningTask) {
+        return;
+    }
+
+    const AccessSet undeclaredWrites = writes & ~runningWrites;
+    const AccessSet undeclaredReads = reads & ~(runningReads | runningWrites);
+    if (undeclaredWrites || undeclaredReads) {
+        std::fprintf(stderr, "%s, within task %s, accesses data the task does not declare: writes [%s], reads [%s]\n",
+                     scope, runningTaskName, describeData(undeclaredWrites, *runningDataNames).c_str(),
+                     describeData(undeclaredReads, *runningDataNames).c_str());
+        std::abort();
+    }
+}
+
+TaskGraph::TaskGraph(std::vector<const char*> dataNames)
+    : dataNames(std::move(dataNames)),
+      nextReady(0),
+      unfinishedTasks(0),
+      pendingJobs(0) {
+}
+
+std::size_t TaskGraph::add(const char* name, const AccessSet reads, const AccessSet writes,
+                           const std::initializer_list<std::size_t> dependencies, Function function,
+                           const std::size_t parts) {
+    const std::size_t index = tasks.size();
+    if (parts == 0) {
+        throw std::string("Task ") + name + " has no parts";
+    }
+
+    Task task;
+    task.name = name;
+    task.reads = reads;
+    task.writes = writes;
+    task.function = std::move(function);
+    task.parts = parts;
+    task.dependencyCount = dependencies.size();
+    task.ancestors.assign(index + 1, false);
+    for (const std::size_t dependency : dependencies) {
+        if (dependency >= index) {
+            throw std::string("Task ") + name + " depends on a task added after it";
+        }
+        tasks[dependency].successors.push_back(index);
+        task.ancestors[dependency] = true;
+        for (std::size_t i = 0; i < dependency; i++) {
+            if (tasks[dependency].ancestors[i]) {
+                task.ancestors[i] = true;
+            }
+        }
+    }
+    task.pendingDependencies = 0;
+    task.pendingParts = 0;
+    task.runningParts = 0;
+    task.started = false;
+    tasks.push_back(std::move(task));
+
+    // Every ancestor is known by now, so a conflict is as good as caught as soon as the task is added
+    if (taskValidationEnabled) {
+        for (std::size_t other = 0; other < index; other++) {
+            const Task& added = tasks[index];
+            const AccessSet conflict = conflictingData(added.reads, added.writes, tasks[other].reads,
+                                                       tasks[other].writes);
+            if (conflict && !added.ancestors[other]) {
+                std::fprintf(stderr, "Tasks %s and %s may run concurrently, yet both access [%s]\n",
+                             added.name, tasks[other].name, describeData(conflict, dataNames).c_str());
+                std::abort();
+            }
+        }
+    }
+
+    return index;
+}
+
+void TaskGraph::run(WorkStealingPool* pool) {
+    if (!pool || pool->workerIndex() >= 0) {
+        for (std::size_t i = 0; i < tasks.size(); i++) {
+            if constexpr (phaseTimingEnabled) {
+                tasks[i].start = std::chrono::steady_clock::now();
+            }
+            runParts(i, 0, tasks[i].parts);
+            if constexpr (phaseTimingEnabled) {
+                tasks[i].end = std::chrono::steady_clock::now();
+            }
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    unfinishedTasks = tasks.size();
+    for (auto& task : tasks) {
+        task.pendingDependencies = task.dependencyCount;
+        task.pendingParts = task.parts;
+        task.started = false;
+    }
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        if (tasks[i].dependencyCount == 0) {
+            schedule(i, *pool);
+        }
+    }
+
+    while (true) {
+        runReady(lock, *pool);
+        if (unfinishedTasks == 0 && pendingJobs == 0) {
+            return;
+        }
+        changed.wait(lock);
+    }
+}
+
+std::size_t TaskGraph::size() const {
+    return tasks.size();
+}
+
+const char* TaskGraph::name(const std::size_t task) const {
+    return tasks[task].name;
+}
+
+float TaskGraph::duration(const std::size_t task) const {
+    return std::chrono::duration<float, std::milli>(tasks[task].end - tasks[task].start).count();
+}
+
+std::vector<std::string> TaskGraph::conflicts() const {
+    std::vector<std::string> result;
+    for (std::size_t later = 0; later < tasks.size(); later++) {
+        for (std::size_t earlier = 0; earlier < later; earlier++) {
+            const AccessSet conflict = conflictingData(tasks[later].reads, tasks[later].writes,
+                                                       tasks[earlier].reads, tasks[earlier].writes);
+            if (conflict && !tasks[later].ancestors[earlier]) {
+                result.push_back(std::string(tasks[earlier].name) + " & " + tasks[later].name + ": " +
+                                 describeData(conflict, dataNames));
+            }
+        }
+    }
+    return result;
+}
+
+void TaskGraph::schedule(const std::size_t task, WorkStealingPool& pool) {
+    for (std::size_t part = 0; part < tasks[task].parts; part++) {
+        ready.emplace_back(task, part);
+    }
+
+    // A job per part lets as many workers as there are parts join in, the calling thread may take them all first
+    pendingJobs += tasks[task].parts;
+    for (std::size_t part = 0; part < tasks[task].parts; part++) {
+        pool.submit([this, &pool] {
+            std::unique_lock<std::mutex> lock(mutex);
+            runReady(lock, pool);
+            pendingJobs--;
+            // Notified with mutex held, as run may return, and the graph be destroyed, as soon as it is released
+            changed.notify_all();
+        });
+    }
+    changed.notify_all();
+}
+
+void TaskGraph::runReady(std::unique_lock<std::mutex>& lock, WorkStealingPool& pool) {
+    while (nextReady < ready.size()) {
+        const std::size_t index = ready[nextReady].first;
+        const std::size_t part = ready[nextReady].second;
+        if (++nextReady == ready.size()) {
+            ready.clear();
+            nextReady = 0;
+        }
+
+        Task& task = tasks[index];
+        if (!task.started) {
+            task.started = true;
+            if constexpr (phaseTimingEnabled) {
+                task.start = std::chrono::steady_clock::now();
+            }
+        }
+        if (taskValidationEnabled) {
+            checkConcurrentAccess(index);
+        }
+        task.runningParts++;
+
+        lock.unlock();
+        runParts(index, part, part + 1);
+        lock.lock();
+
+        task.runningParts--;
+        if (--task.pendingParts > 0) {
+            continue;
+        }
+
+        if constexpr (phaseTimingEnabled) {
+            task.end = std::chrono::steady_clock::now();
+        }
+        unfinishedTasks--;
+        for (const std::size_t successor : task.successors) {
+            if (--tasks[successor].pendingDependencies == 0) {
+                schedule(successor, pool);
+            }
+        }
+        changed.notify_all();
+    }
+}
+
+void TaskGraph::runParts(const std::size_t task, const std::size_t first, const std::size_t end) {
+    if (!taskValidationEnabled) {
+        tasks[task].function(first, end);
+        return;
+    }
+
+    // Saved, as serial runs may be nested within a task of another graph
+    const bool previousRunning = runningTask;
+    const char* previousName = runningTaskName;
+    const AccessSet previousReads = runningReads;
+    const AccessSet previousWrites = runningWrites;
+    const std::vector<const char*>* previousDataNames = runningDataNames;
+
+    runningTask = true;
+    runningTaskName = tasks[task].name;
+    runningReads = tasks[task].reads;
+    runningWrites = tasks[task].writes;
+    runningDataNames = &dataNames;
+
+    tasks[task].function(first, end);
+
+    runningTask = previousRunning;
+    runningTaskName = previousName;
+    runningReads = previousReads;
+    runningWrites = previousWrites;
+    runningDataNames = previousDataNames;
+}
+
+void TaskGraph::checkConcurrentAccess(const std::size_t task) const {
+    for (std::size_t other = 0; other < tasks.size(); other++) {
+        if (other == task || tasks[other].runningParts == 0) {
+            continue;
+        }
+
+        const AccessSet conflict = conflictingData(tasks[task].reads, tasks[task].writes, tasks[other].reads,
+                                                   tasks[other].writes);
+        if (conflict) {
+            std::fprintf(stderr, "Tasks %s and %s ran concurrently, yet both access [%s]\n",
+                         tasks[task].name, tasks[other].name, describeData(conflict, dataNames).c_str());
+            std::abort();
+        }
+    }
+}
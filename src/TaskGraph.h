@@ -0,0 +1,123 @@
+#ifndef TASK_GRAPH
+#define TASK_GRAPH
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "WorkStealingPool.h"
+
+// Built with ENABLE_TASK_VALIDATION defined, every run of a TaskGraph checks that tasks accessing the same data
+// never overlap and that CHECK_TASK_ACCESS scopes stay within the running task's declared accesses, aborting
+// on the first violation. Built without it the checks expand to nothing
+#ifdef ENABLE_TASK_VALIDATION
+constexpr bool taskValidationEnabled = true;
+#define CHECK_TASK_ACCESS(reads, writes) checkTaskAccess(reads, writes, __func__)
+#else
+constexpr bool taskValidationEnabled = false;
+#define CHECK_TASK_ACCESS(reads, writes)
+#endif
+
+// One bit per piece of data tasks read or write, as numbered by the owner of the graph
+typedef std::uint32_t AccessSet;
+
+// Aborts if the task running on the calling thread, if any, did not declare reading reads & writing writes
+// Writing implies reading, scope names the code checked, e.g. a function name
+void checkTaskAccess(AccessSet reads, AccessSet writes, const char* scope);
+
+// Static set of tasks run on every call to run, each once every task it depends on has finished
+// Tasks declare the data they read and write, which is what makes running them concurrently safe to check:
+// any two tasks accessing the same data, either of them writing it, must depend on one another
+// A task may be split into parts working on disjoint slices of its data, which run concurrently too
+class TaskGraph {
+public:
+    // Parts function(first, end) run, end excluded
+    typedef std::function<void(std::size_t first, std::size_t end)> Function;
+
+    // dataNames names every bit of an AccessSet in order, for reporting conflicts
+    explicit TaskGraph(std::vector<const char*> dataNames);
+
+    TaskGraph(const TaskGraph&) = delete;
+
+    TaskGraph& operator =(const TaskGraph&) = delete;
+
+    // Adds a task of parts parts running after dependencies, indices returned by earlier calls, returns its index
+    // Run serially, function is called once for every part at once, concurrently once per part
+    // name must outlive the graph, e.g. a string literal
+    std::size_t add(const char* name, AccessSet reads, AccessSet writes, std::initializer_list<std::size_t> dependencies,
+                    Function function, std::size_t parts = 1);
+
+    // Runs every task on pool, the calling thread taking part, and returns once all of them have finished
+    // Runs them serially, in order of addition, if pool is null or the calling thread is one of its workers,
+    // since a worker blocking on other tasks of its own pool could wait forever
+    void run(WorkStealingPool* pool);
+
+    std::size_t size() const;
+
+    const char* name(std::size_t task) const;
+
+    // Measured in milliseconds, from the start of task's first part to the end of its last part in the latest run
+    // Always 0 built without ENABLE_PHASE_TIMING, as tasks are then never timed
+    float duration(std::size_t task) const;
+
+    // Every pair of tasks accessing the same data, either of them writing it, neither depending on the other
+    // Each is described along with the data, empty if tasks never conflict however they are scheduled
+    std::vector<std::string> conflicts() const;
+
+private:
+    struct Task {
+        const char* name;
+        AccessSet reads;
+        AccessSet writes;
+        Function function;
+        std::size_t parts;
+        std::vector<std::size_t> successors;
+        std::size_t dependencyCount;
+        // Dependencies, direct or not
+        std::vector<bool> ancestors;
+
+        // State of the current run, guarded by mutex
+        std::size_t pendingDependencies;
+        std::size_t pendingParts;
+        std::size_t runningParts;
+        bool started;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+    };
+
+    const std::vector<const char*> dataNames;
+    std::vector<Task> tasks;
+
+    // Guards the run state below and that of every task
+    std::mutex mutex;
+    // Signalled whenever parts become ready or a task finishes
+    std::condition_variable changed;
+    // Parts ready to run, as (task, part), from nextReady on
+    // Emptied whenever all of them have been taken, so that it keeps its capacity and runs stop allocating
+    std::vector<std::pair<std::size_t, std::size_t>> ready;
+    std::size_t nextReady;
+    std::size_t unfinishedTasks;
+    // Jobs submitted to the pool not yet returned, run waits for them as they refer to this graph
+    std::size_t pendingJobs;
+
+    // Queues every part of task and submits a job per part to pool, with mutex held
+    void schedule(std::size_t task, WorkStealingPool& pool);
+
+    // Runs ready parts until there are none left, returns with mutex held
+    void runReady(std::unique_lock<std::mutex>& lock, WorkStealingPool& pool);
+
+    // Validates and calls function(first, end) of task
+    void runParts(std::size_t task, std::size_t first, std::size_t end);
+
+    // Aborts if task conflicts with any task currently running, with mutex held
+    void checkConcurrentAccess(std::size_t task) const;
+};
+
+#endif
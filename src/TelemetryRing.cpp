@@ -0,0 +1,183 @@
+#include "TelemetryRing.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const std::array<char, 8> telemetryMagic = {'B', 'F', 'T', 'E', 'L', 'E', 'M', '\0'};
+
+// Bytes of the shared memory object holding capacity slots
+std::size_t telemetryMappingSize(const std::uint32_t capacity) {
+    return sizeof(TelemetryHeader) + capacity * sizeof(TelemetrySlot);
+}
+
+// shm_open names start with a single slash
+std::string sharedMemoryName(const char* name) {
+    return name[0] == '/' ? std::string(name) : '/' + std::string(name);
+}
+
+TelemetryPublisher::TelemetryPublisher()
+    : mapping(nullptr),
+      mappingSize(0),
+      header(nullptr),
+      ring(nullptr) {
+}
+
+TelemetryPublisher::~TelemetryPublisher() {
+    close();
+}
+
+bool TelemetryPublisher::open(const char* name, const std::uint32_t capacity) {
+    close();
+    if (capacity == 0) {
+        return false;
+    }
+
+    this->name = sharedMemoryName(name);
+    // Readers of a previous ring keep their own mapping of it, new readers find this one
+    shm_unlink(this->name.c_str());
+    const int descriptor = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (descriptor < 0) {
+        return false;
+    }
+
+    mappingSize = telemetryMappingSize(capacity);
+    if (ftruncate(descriptor, static_cast<off_t>(mappingSize)) != 0) {
+        ::close(descriptor);
+        shm_unlink(this->name.c_str());
+        return false;
+    }
+    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    // The mapping outlives the descriptor
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        shm_unlink(this->name.c_str());
+        return false;
+    }
+
+    // ftruncate zero-fills, so every slot already reads as never written
+    ring = reinterpret_cast<TelemetrySlot*>(static_cast<char*>(mapping) + sizeof(TelemetryHeader));
+    for (std::uint32_t i = 0; i < capacity; i++) {
+        new (&ring[i].sequence) std::atomic<std::uint64_t>(0);
+    }
+
+    // Written last, readers check magic before trusting anything else
+    header = static_cast<TelemetryHeader*>(mapping);
+    new (&header->published) std::atomic<std::uint64_t>(0);
+    header->version = telemetryVersion;
+    header->recordSize = sizeof(TelemetryRecord);
+    header->capacity = capacity;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = telemetryMagic;
+    return true;
+}
+
+void TelemetryPublisher::close() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+        shm_unlink(name.c_str());
+        mapping = nullptr;
+        header = nullptr;
+        ring = nullptr;
+    }
+}
+
+bool TelemetryPublisher::isOpen() const {
+    return mapping != nullptr;
+}
+
+TelemetryRecord& TelemetryPublisher::back() {
+    // Only this thread writes published, relaxed loads see its own stores
+    const std::uint64_t n = header->published.load(std::memory_order_relaxed);
+    TelemetrySlot& slot = ring[n % header->capacity];
+    slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+    // Readers that see any of the record's new bytes also see the odd sequence
+    std::atomic_thread_fence(std::memory_order_release);
+    return slot.record;
+}
+
+void TelemetryPublisher::publish() {
+    const std::uint64_t n = header->published.load(std::memory_order_relaxed);
+    ring[n % header->capacity].sequence.store(2 * n + 2, std::memory_order_release);
+    header->published.store(n + 1, std::memory_order_release);
+}
+
+TelemetryReader::TelemetryReader()
+    : mapping(nullptr),
+      mappingSize(0),
+      header(nullptr),
+      ring(nullptr) {
+}
+
+TelemetryReader::~TelemetryReader() {
+    close();
+}
+
+bool TelemetryReader::open(const char* name) {
+    close();
+
+    const int descriptor = shm_open(sharedMemoryName(name).c_str(), O_RDONLY, 0);
+    if (descriptor < 0) {
+        return false;
+    }
+
+    struct stat status{};
+    if (fstat(descriptor, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(TelemetryHeader)) {
+        ::close(descriptor);
+        return false;
+    }
+    mappingSize = static_cast<std::size_t>(status.st_size);
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        return false;
+    }
+
+    header = static_cast<const TelemetryHeader*>(mapping);
+    const bool valid = header->magic == telemetryMagic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid || header->version != telemetryVersion || header->recordSize != sizeof(TelemetryRecord) ||
+        header->capacity == 0 || telemetryMappingSize(header->capacity) > mappingSize) {
+        close();
+        return false;
+    }
+
+    ring = reinterpret_cast<const TelemetrySlot*>(static_cast<const char*>(mapping) + sizeof(TelemetryHeader));
+    return true;
+}
+
+void TelemetryReader::close() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        header = nullptr;
+        ring = nullptr;
+    }
+}
+
+std::uint32_t TelemetryReader::capacity() const {
+    return header->capacity;
+}
+
+std::uint64_t TelemetryReader::published() const {
+    return header->published.load(std::memory_order_acquire);
+}
+
+bool TelemetryReader::read(const std::uint64_t n, TelemetryRecord& record) const {
+    const TelemetrySlot& slot = ring[n % header->capacity];
+    const std::uint64_t complete = 2 * n + 2;
+    if (slot.sequence.load(std::memory_order_acquire) != complete) {
+        return false;
+    }
+
+    std::memcpy(&record, &slot.record, sizeof(TelemetryRecord));
+
+    // The copy is only whole if the publisher did not start overwriting the slot meanwhile
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == complete;
+}
@@ -0,0 +1,126 @@
+#ifndef TELEMETRY_RING
+#define TELEMETRY_RING
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "Scene.h"
+
+// Bumped whenever the layout of TelemetryHeader, TelemetrySlot or TelemetryRecord changes
+constexpr std::uint32_t telemetryVersion = 1;
+
+// Records kept in the ring, a little over a minute of ticks at 60 Hz
+constexpr std::uint32_t defaultTelemetryCapacity = 4096;
+
+// State of a Scene after a tick, laid out identically for every process mapping the ring
+struct TelemetryRecord {
+    std::uint64_t tick;
+    // Measured in seconds, total time simulated so far
+    float simulationTime;
+    float planePosition[3];
+    // Rotation part of planeRotation, row by row, its columns are the plane's x, forward & z axes in world space
+    float planeRotation[9];
+    // Measured in meters/tick
+    float flightSpeed;
+    std::uint32_t liveLavaBombs;
+    std::uint32_t aircraft;
+    // CrashCause, None until the plane crashes
+    std::uint32_t crashCause;
+    // Measured in milliseconds, per UpdatePhase of this tick, all zeroes unless built with ENABLE_PHASE_TIMING
+    float updatePhaseTimes[updatePhaseCount];
+};
+
+static_assert(std::is_trivially_copyable<TelemetryRecord>::value, "Telemetry records are copied as bytes");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Atomics in shared memory must be lock-free");
+
+// Start of the shared memory object, followed by capacity TelemetrySlots
+struct TelemetryHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint32_t capacity;
+    std::uint32_t reserved;
+    // Records published so far, record n lives in slot n % capacity
+    std::atomic<std::uint64_t> published;
+};
+
+// sequence is 2n + 1 while record n is written into the slot, then 2n + 2 once it is complete
+// Readers copy the record out and keep it only if sequence read the same before and after
+struct TelemetrySlot {
+    std::atomic<std::uint64_t> sequence;
+    TelemetryRecord record;
+};
+
+// Writes TelemetryRecords into a ring in POSIX shared memory, for other processes to read as they are published
+// Single producer: one thread writes, and it never waits on readers, who lose records they fall capacity behind on
+class TelemetryPublisher {
+public:
+    TelemetryPublisher();
+
+    // Unmaps the ring and removes its name
+    ~TelemetryPublisher();
+
+    TelemetryPublisher(const TelemetryPublisher&) = delete;
+
+    TelemetryPublisher& operator =(const TelemetryPublisher&) = delete;
+
+    // Creates, or replaces, the shared memory object name, e.g. "/basic-flight"
+    // returns true on success, false otherwise
+    bool open(const char* name, std::uint32_t capacity = defaultTelemetryCapacity);
+
+    void close();
+
+    bool isOpen() const;
+
+    // Record to fill in place before calling publish, readers skip it until then
+    TelemetryRecord& back();
+
+    // Makes the record returned by back visible to readers
+    void publish();
+
+private:
+    std::string name;
+    void* mapping;
+    std::size_t mappingSize;
+    TelemetryHeader* header;
+    TelemetrySlot* ring;
+};
+
+// Maps a ring created by a TelemetryPublisher read-only, records are read straight from the shared pages
+// Any number of readers may follow the same ring, none of them affects the publisher
+class TelemetryReader {
+public:
+    TelemetryReader();
+
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader&) = delete;
+
+    TelemetryReader& operator =(const TelemetryReader&) = delete;
+
+    // returns true on success, false otherwise, e.g. if no publisher created name or its layout differs
+    bool open(const char* name);
+
+    void close();
+
+    std::uint32_t capacity() const;
+
+    // Records published so far
+    std::uint64_t published() const;
+
+    // Copies record n into record
+    // returns true on success, false if it was not published yet or was overwritten since
+    bool read(std::uint64_t n, TelemetryRecord& record) const;
+
+private:
+    void* mapping;
+    std::size_t mappingSize;
+    const TelemetryHeader* header;
+    const TelemetrySlot* ring;
+};
+
+#endif
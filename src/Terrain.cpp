@@ -1,31 +1,117 @@
 #include "Terrain.h"
 
-#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "TextScanner.h"
+#include "TraceEvents.h"
+
+// Below this many bytes per thread, height values are parsed on fewer threads, down to the calling thread alone
+constexpr std::size_t heightValueChunkMinimumBytes = 1 << 20;
+
+// Appends the height values of text to values
+void parseHeightValueChunk(const char* begin, const char* end, std::vector<float>& values) {
+    TextScanner scanner(begin, end);
+    float value = 0.0f;
+    while (scanner.read(value)) {
+        values.push_back(value);
+    }
+}
+
+void parseHeightValues(const char* begin, const char* end, std::vector<float>& values) {
+    TRACE_SCOPE("load", "parseHeightValues");
+
+    const std::size_t size = end - begin;
+    const std::size_t nChunks = std::max<std::size_t>(
+        1, std::min<std::size_t>(std::thread::hardware_concurrency(), size / heightValueChunkMinimumBytes));
+    if (nChunks == 1) {
+        parseHeightValueChunk(begin, end, values);
+        return;
+    }
+
+    // Chunks end at line breaks, so each holds whole rows when the file has a row per line
+    // and values are never split whatever the layout
+    std::vector<const char*> boundaries{begin};
+    for (std::size_t chunk = 1; chunk < nChunks; chunk++) {
+        const char* boundary = std::max(boundaries.back(), begin + chunk * size / nChunks);
+        while (boundary != end && *boundary != '\n') {
+            boundary++;
+        }
+        boundaries.push_back(boundary);
+    }
+    boundaries.push_back(end);
+
+    // Each chunk is parsed into a vector of its own, the calling thread taking the first
+    std::vector<std::vector<float>> chunkValues(nChunks);
+    std::vector<std::thread> parsers;
+    for (std::size_t chunk = 1; chunk < nChunks; chunk++) {
+        parsers.emplace_back(parseHeightValueChunk, boundaries[chunk], boundaries[chunk + 1],
+                             std::ref(chunkValues[chunk]));
+    }
+    parseHeightValueChunk(boundaries[0], boundaries[1], chunkValues[0]);
+    for (std::thread& parser : parsers) {
+        parser.join();
+    }
 
-Terrain::Terrain(): xyScale(1) {
+    for (const std::vector<float>& chunk : chunkValues) {
+        values.insert(values.end(), chunk.begin(), chunk.end());
+    }
+}
+
+Terrain::Terrain(): xyScale(1), minimumHeight(0.0f), maximumSlope(0.0f) {
 }
 
 bool Terrain::readTerrainFile(const char* fileName, const float xyScale) {
-    std::ifstream inFile(fileName);
-    if (inFile.bad()) {
+    TRACE_SCOPE("load", "readTerrainFile");
+
+    std::string contents;
+    if (!readWholeFile(fileName, contents)) {
         return false;
     }
+    TextScanner scanner(contents);
 
     // save the xy scale
     this->xyScale = xyScale;
 
     long height = 0, width = 0;
-    inFile >> height >> width;
+    scanner.read(height);
+    scanner.read(width);
+
+    // All height values, row after row
+    std::vector<float> values;
+    parseHeightValues(scanner.position, scanner.end, values);
+    values.resize(height * width, 0.0f);
 
     // Per row height values
     heightValues.resize(height);
     for (int row = 0; row < height; row++) {
-        heightValues[row].resize(width);
+        heightValues[row].assign(values.begin() + row * width, values.begin() + (row + 1) * width);
+    }
 
+    // Bounds used by queries that need to reason about the whole heightfield
+    minimumHeight = heightValues.empty() || heightValues[0].empty() ? 0.0f : heightValues[0][0];
+    maximumSlope = 0.0f;
+    for (int row = 0; row < height; row++) {
         for (int col = 0; col < width; col++) {
-            inFile >> heightValues[row][col];
+            minimumHeight = std::min(minimumHeight, heightValues[row][col]);
+
+            // Triangles are right triangles with diagonal TL-BR, so their gradients are made up of
+            // the height changes along the grid edges forming their legs
+            if (col + 1 < width) {
+                maximumSlope = std::max(maximumSlope, std::abs(heightValues[row][col + 1] - heightValues[row][col]));
+            }
+            if (row + 1 < height) {
+                maximumSlope = std::max(maximumSlope, std::abs(heightValues[row + 1][col] - heightValues[row][col]));
+            }
         }
     }
+    // Each gradient has two such components, hence the sqrt(2)
+    maximumSlope *= std::sqrt(2.0f) / xyScale;
 
     // We want the triangles to be centred at the origin,
     // with the zero elevation set at 0 z, so we have to juggle things somewhat
@@ -36,40 +122,34 @@ bool Terrain::readTerrainFile(const char* fileName, const float xyScale) {
         midPoint.z = 0.0
     };
 
-    // each square of data is two triangles, but the end values don't have squares,
-    // so we don't need quite as many vertices
-    int nTriangles = (height - 1) * (width - 1) * 2;
-    vertices.resize(3 * nTriangles);
+    // A vertex per height value, shared by the up to six triangles around it
+    std::vector<Cartesian3> positions;
+    positions.reserve(height * width);
+    for (int row = 0; row < height; row++) {
+        for (int col = 0; col < width; col++) {
+            positions.emplace_back(xyScale * col - midPoint.x, midPoint.y - xyScale * row, heightValues[row][col]);
+        }
+    }
+
+    // each square of data is two triangles, but the end values don't have squares
+    const auto vertex = [width](const int row, const int col) {
+        return static_cast<std::uint32_t>(row * width + col);
+    };
+    std::vector<std::uint32_t> indices;
+    indices.reserve(std::max(0L, (height - 1) * (width - 1) * 6));
 
     // Create 2 triangles from square
-    int vertex = 0;
     for (int row = 0; row < height - 1; row++) {
         for (int col = 0; col < width - 1; col++) {
             // Triangle 1
-            vertices[vertex++] = Cartesian3(xyScale * col - midPoint.x,
-                                            midPoint.y - xyScale * row,
-                                            heightValues[row][col]);
-            vertices[vertex++] = Cartesian3(xyScale * (col + 1) - midPoint.x,
-                                            midPoint.y - xyScale * (row + 1),
-                                            heightValues[row + 1][col + 1]);
-            vertices[vertex++] = Cartesian3(xyScale * (col + 1) - midPoint.x,
-                                            midPoint.y - xyScale * row,
-                                            heightValues[row][col + 1]);
+            indices.insert(indices.end(), {vertex(row, col), vertex(row + 1, col + 1), vertex(row, col + 1)});
 
             // Triangle 2
-            vertices[vertex++] = Cartesian3(xyScale * col - midPoint.x,
-                                            midPoint.y - xyScale * row,
-                                            heightValues[row][col]);
-            vertices[vertex++] = Cartesian3(xyScale * col - midPoint.x,
-                                            midPoint.y - xyScale * (row + 1),
-                                            heightValues[row + 1][col]);
-            vertices[vertex++] = Cartesian3(xyScale * (col + 1) - midPoint.x,
-                                            midPoint.y - xyScale * (row + 1),
-                                            heightValues[row + 1][col + 1]);
+            indices.insert(indices.end(), {vertex(row, col), vertex(row + 1, col), vertex(row + 1, col + 1)});
         }
     }
 
-    computeUnitNormalVectors();
+    mesh.build(std::move(positions), std::move(indices));
 
     return true;
 }
@@ -139,3 +219,34 @@ float Terrain::getHeight(float x, float y) const {
 
     return height;
 }
+
+bool Terrain::contains(const float x, const float y) const {
+    if (heightValues.empty()) {
+        return false;
+    }
+
+    // Mirrors the index computation of getHeight, which reads (row + 1, column + 1)
+    const long nRows = heightValues.size();
+    const long nColumns = heightValues[0].size();
+
+    const float column = (x + nColumns / 2 * xyScale) / xyScale;
+    const float row = ((nRows - 1) * xyScale - (y + nRows / 2 * xyScale)) / xyScale;
+
+    return column >= 0.0f && row >= 0.0f && column < nColumns - 1 && row < nRows - 1;
+}
+
+MemoryReport Terrain::memoryReport() const {
+    MemoryReport report;
+    report.add("heightValues.rows", heightValues);
+
+    std::size_t size = 0;
+    std::size_t capacity = 0;
+    for (const auto& row : heightValues) {
+        size += row.size();
+        capacity += row.capacity();
+    }
+    report.add("heightValues.values", sizeof(float), size, capacity, size);
+
+    report.add("", HomogeneousFaceSurface::memoryReport());
+    return report;
+}
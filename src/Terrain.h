@@ -5,12 +5,22 @@
 
 #include "HomogeneousFaceSurface.h"
 
+// Appends the whitespace separated height values between begin and end to values
+// Large texts are split at line breaks into chunks parsed on several threads
+void parseHeightValues(const char* begin, const char* end, std::vector<float>& values);
+
 class Terrain : public HomogeneousFaceSurface {
 public:
     // height value per (x, y) coordinate
     std::vector<std::vector<float>> heightValues;
     float xyScale;
 
+    // lowest height value, used to discard queries far below the terrain
+    float minimumHeight;
+
+    // upper bound on the gradient magnitude of the heightfield, in height units per unit of (x, y)
+    float maximumSlope;
+
     Terrain();
 
     // reads .dem elevation/terrain model
@@ -19,6 +29,12 @@ public:
 
     // query height at a known (x, y) coordinate
     float getHeight(float x, float y) const;
+
+    // whether (x, y) lies within the heightfield, i.e. getHeight(x, y) is well-defined
+    bool contains(float x, float y) const;
+
+    // Footprint of heightValues, rows & values apart, followed by the triangle soup's
+    MemoryReport memoryReport() const;
 };
 
 #endif
@@ -0,0 +1,33 @@
+#include "TextScanner.h"
+
+#include <fstream>
+
+bool readWholeFile(const char* fileName, std::string& contents) {
+    std::ifstream inFile(fileName, std::ios::binary | std::ios::ate);
+    if (!inFile.good()) {
+        return false;
+    }
+
+    const std::streamoff size = inFile.tellg();
+    if (size < 0) {
+        return false;
+    }
+
+    contents.resize(static_cast<std::size_t>(size));
+    inFile.seekg(0);
+    return static_cast<bool>(inFile.read(contents.data(), size));
+}
+
+bool TextScanner::readToken(std::string_view& token) {
+    skipWhitespace();
+    if (position == end) {
+        return false;
+    }
+
+    const char* const start = position;
+    while (position != end && !isWhitespace(*position)) {
+        position++;
+    }
+    token = std::string_view(start, position - start);
+    return true;
+}
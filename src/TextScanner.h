@@ -0,0 +1,62 @@
+#ifndef TEXT_SCANNER
+#define TEXT_SCANNER
+
+#include <charconv>
+#include <string>
+#include <string_view>
+
+// Reads fileName in a single bulk read, replacing contents
+// returns true on success, false otherwise
+bool readWholeFile(const char* fileName, std::string& contents);
+
+// Whitespace separated values parsed in place from a text held in memory, with std::from_chars
+// Unlike a stream's operator>>, no locale, sentry or per value virtual call is involved
+class TextScanner {
+public:
+    const char* position;
+    const char* end;
+
+    TextScanner(const char* begin, const char* end)
+        : position(begin),
+          end(end) {
+    }
+
+    explicit TextScanner(std::string_view text)
+        : TextScanner(text.data(), text.data() + text.size()) {
+    }
+
+    // Skips whitespace, then parses a number of type T
+    // returns false and leaves value as is at the end of the text or on a malformed number
+    template <typename T>
+    bool read(T& value) {
+        skipWhitespace();
+        // from_chars rejects the leading plus sign that operator>> accepts
+        if (position != end && *position == '+') {
+            position++;
+        }
+        const std::from_chars_result result = std::from_chars(position, end, value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        position = result.ptr;
+        return true;
+    }
+
+    // Skips whitespace, then reads the characters up to the next whitespace
+    // returns false at the end of the text
+    bool readToken(std::string_view& token);
+
+    // Moves past spaces, tabs & line breaks
+    void skipWhitespace() {
+        while (position != end && isWhitespace(*position)) {
+            position++;
+        }
+    }
+
+    static bool isWhitespace(const char character) {
+        return character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '\v' ||
+               character == '\f';
+    }
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "TraceEvents.h"
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+std::atomic<bool> tracingEnabled(false);
+
+// Written by its owning thread only, count publishes the events before it to writeTraceFile
+struct ThreadTraceBuffer {
+    unsigned int threadId;
+    std::atomic<const char*> threadName{nullptr};
+    std::atomic<std::size_t> count{0};
+    std::atomic<std::size_t> dropped{0};
+    std::unique_ptr<TraceEvent[]> events;
+};
+
+// Buffers outlive their threads, so that events of finished threads are still written
+std::mutex traceBuffersMutex;
+std::vector<std::unique_ptr<ThreadTraceBuffer>> traceBuffers;
+
+Clock::time_point traceEpoch;
+
+ThreadTraceBuffer& threadTraceBuffer() {
+    // Registration locks once per thread, recording never does
+    thread_local ThreadTraceBuffer* buffer = [] {
+        auto newBuffer = std::make_unique<ThreadTraceBuffer>();
+        newBuffer->events = std::make_unique<TraceEvent[]>(traceBufferCapacity);
+
+        std::lock_guard<std::mutex> lock(traceBuffersMutex);
+        newBuffer->threadId = static_cast<unsigned int>(traceBuffers.size()) + 1;
+        traceBuffers.push_back(std::move(newBuffer));
+        return traceBuffers.back().get();
+    }();
+    return *buffer;
+}
+
+void startTracing() {
+    traceEpoch = Clock::now();
+    tracingEnabled.store(true, std::memory_order_release);
+}
+
+void stopTracing() {
+    tracingEnabled.store(false, std::memory_order_release);
+}
+
+void setTraceThreadName(const char* name) {
+    threadTraceBuffer().threadName.store(name, std::memory_order_release);
+}
+
+void recordTraceEvent(const char* category, const char* name, const Clock::time_point start,
+                      const Clock::time_point end) {
+    ThreadTraceBuffer& buffer = threadTraceBuffer();
+
+    const std::size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index >= traceBufferCapacity) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer.events[index] = {
+        category,
+        name,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(start - traceEpoch).count(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()
+    };
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+bool writeTraceFile(const char* fileName) {
+    std::ofstream outFile(fileName);
+    if (!outFile.good()) {
+        return false;
+    }
+
+    // Chrome trace timestamps are in microseconds, nanosecond precision is kept as fractions
+    outFile << std::fixed << std::setprecision(3);
+    outFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool first = true;
+    const auto separate = [&outFile, &first]() {
+        if (!first) {
+            outFile << ",\n";
+        }
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lock(traceBuffersMutex);
+    for (const auto& buffer : traceBuffers) {
+        if (const char* threadName = buffer->threadName.load(std::memory_order_acquire)) {
+            separate();
+            outFile << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->threadId
+                    << ",\"args\":{\"name\":\"" << threadName << "\"}}";
+        }
+
+        const std::size_t count = buffer->count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; i++) {
+            const TraceEvent& event = buffer->events[i];
+            separate();
+            outFile << "{\"ph\":\"X\",\"cat\":\"" << event.category << "\",\"name\":\"" << event.name
+                    << "\",\"pid\":1,\"tid\":" << buffer->threadId
+                    << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0 << "}";
+        }
+
+        // Marked right after the last event kept
+        if (const std::size_t dropped = buffer->dropped.load(std::memory_order_relaxed); dropped > 0 && count > 0) {
+            const TraceEvent& last = buffer->events[count - 1];
+            separate();
+            outFile << "{\"ph\":\"i\",\"s\":\"t\",\"name\":\"" << dropped << " events dropped, buffer full\""
+                    << ",\"pid\":1,\"tid\":" << buffer->threadId
+                    << ",\"ts\":" << (last.start + last.duration) / 1000.0 << "}";
+        }
+    }
+
+    outFile << "\n]}\n";
+    return outFile.good();
+}
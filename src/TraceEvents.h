@@ -0,0 +1,82 @@
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Timeline of scoped events, written out as Chrome trace_event JSON to open in Perfetto or chrome://tracing.
+ *
+ * Each thread appends to a buffer of its own, registered on its first event, so recording never takes a lock.
+ * Names and categories are not copied, they must outlive writeTraceFile, e.g. string literals.
+ * While tracing is off, which is the default, a scope costs a single relaxed load.
+ */
+
+#define TRACE_SCOPE(category, name) ScopedTraceEvent traceEvent(category, name)
+
+// Events kept per thread, later ones are dropped and counted
+constexpr std::size_t traceBufferCapacity = 1 << 18;
+
+struct TraceEvent {
+    const char* category;
+    const char* name;
+    // Measured in nanoseconds since startTracing
+    std::int64_t start;
+    std::int64_t duration;
+};
+
+extern std::atomic<bool> tracingEnabled;
+
+// Starts recording events, on every thread
+// Called before starting the threads to trace, as it also resets the timeline's origin
+void startTracing();
+
+void stopTracing();
+
+inline bool isTracing() {
+    return tracingEnabled.load(std::memory_order_relaxed);
+}
+
+// Names the calling thread's track in the timeline, name must outlive writeTraceFile
+void setTraceThreadName(const char* name);
+
+// Appends an event to the calling thread's buffer
+void recordTraceEvent(const char* category, const char* name, std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end);
+
+// Writes every event recorded so far, threads may keep recording meanwhile but their latest events may be missed
+// returns true on success, false otherwise
+bool writeTraceFile(const char* fileName);
+
+// Records the time between its construction and destruction as one event, if tracing at construction
+class ScopedTraceEvent {
+public:
+    ScopedTraceEvent(const char* category, const char* name)
+        : category(category),
+          name(name),
+          active(isTracing()) {
+        if (active) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedTraceEvent() {
+        if (active) {
+            recordTraceEvent(category, name, start, std::chrono::steady_clock::now());
+        }
+    }
+
+    ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+
+    ScopedTraceEvent& operator =(const ScopedTraceEvent&) = delete;
+
+private:
+    const char* category;
+    const char* name;
+    const bool active;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif
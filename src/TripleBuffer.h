@@ -0,0 +1,41 @@
+#ifndef TRIPLE_BUFFER
+#define TRIPLE_BUFFER
+
+#include <atomic>
+
+// Hands the latest value written by one thread to one reader thread without either ever waiting
+// The writer fills the back buffer while the reader holds the front one, a third buffer is kept in between
+// so that publishing and reading only ever swap indices
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer only, buffer to fill before calling publish
+    T& back() {
+        return buffers[backIndex];
+    }
+
+    // Writer only, makes back the latest value and hands out a new back buffer
+    void publish() {
+        backIndex = middle.exchange(backIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader only, latest published value, which stays untouched until the next call
+    const T& front() {
+        if (middle.load(std::memory_order_relaxed) & freshBit) {
+            frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+        }
+        return buffers[frontIndex];
+    }
+
+private:
+    static constexpr int freshBit = 4;
+    static constexpr int indexMask = 3;
+
+    T buffers[3];
+    int backIndex = 0;
+    // Index of the buffer in between, with freshBit set if it was published after the reader's last swap
+    std::atomic<int> middle{1};
+    int frontIndex = 2;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "UdpSocket.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Room for a few hundred snapshots, so that bursts to many clients are not dropped
+constexpr int socketBufferSize = 4 << 20;
+
+sockaddr_in toSocketAddress(const UdpAddress& address) {
+    sockaddr_in socketAddress{};
+    socketAddress.sin_family = AF_INET;
+    socketAddress.sin_addr.s_addr = htonl(address.host);
+    socketAddress.sin_port = htons(address.port);
+    return socketAddress;
+}
+
+UdpSocket::UdpSocket()
+    : descriptor(-1) {
+}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::open(const std::uint16_t port) {
+    close();
+
+    descriptor = socket(AF_INET, SOCK_DGRAM, 0);
+    if (descriptor < 0) {
+        return false;
+    }
+
+    // Buffer sizes are best effort, the system may cap them
+    setsockopt(descriptor, SOL_SOCKET, SO_SNDBUF, &socketBufferSize, sizeof(socketBufferSize));
+    setsockopt(descriptor, SOL_SOCKET, SO_RCVBUF, &socketBufferSize, sizeof(socketBufferSize));
+
+    sockaddr_in socketAddress = toSocketAddress({INADDR_LOOPBACK, port});
+    socklen_t length = sizeof(socketAddress);
+    if (fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL, 0) | O_NONBLOCK) != 0 ||
+        bind(descriptor, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0 ||
+        getsockname(descriptor, reinterpret_cast<sockaddr*>(&socketAddress), &length) != 0) {
+        close();
+        return false;
+    }
+
+    boundAddress = {ntohl(socketAddress.sin_addr.s_addr), ntohs(socketAddress.sin_port)};
+    return true;
+}
+
+void UdpSocket::close() {
+    if (descriptor >= 0) {
+        ::close(descriptor);
+        descriptor = -1;
+    }
+}
+
+bool UdpSocket::isOpen() const {
+    return descriptor >= 0;
+}
+
+UdpAddress UdpSocket::address() const {
+    return boundAddress;
+}
+
+bool UdpSocket::send(const UdpAddress& destination, const void* data, const std::size_t size) {
+    const sockaddr_in socketAddress = toSocketAddress(destination);
+    const ssize_t sent = sendto(descriptor, data, size, 0, reinterpret_cast<const sockaddr*>(&socketAddress),
+                                sizeof(socketAddress));
+    return sent == static_cast<ssize_t>(size);
+}
+
+long UdpSocket::receive(UdpAddress& source, void* data, const std::size_t capacity) {
+    sockaddr_in socketAddress{};
+    socklen_t length = sizeof(socketAddress);
+    const ssize_t received = recvfrom(descriptor, data, capacity, 0, reinterpret_cast<sockaddr*>(&socketAddress),
+                                      &length);
+    if (received < 0) {
+        return -1;
+    }
+
+    source = {ntohl(socketAddress.sin_addr.s_addr), ntohs(socketAddress.sin_port)};
+    return static_cast<long>(received);
+}
+
+bool UdpSocket::wait(const int timeoutMilliseconds) {
+    pollfd pending{descriptor, POLLIN, 0};
+    return poll(&pending, 1, timeoutMilliseconds) > 0 && (pending.revents & POLLIN) != 0;
+}
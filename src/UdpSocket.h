@@ -0,0 +1,58 @@
+#ifndef UDP_SOCKET
+#define UDP_SOCKET
+
+#include <cstddef>
+#include <cstdint>
+
+// IPv4 address & port, in host byte order
+struct UdpAddress {
+    std::uint32_t host = 0;
+    std::uint16_t port = 0;
+
+    bool operator==(const UdpAddress& other) const {
+        return host == other.host && port == other.port;
+    }
+};
+
+// Largest datagram sent or received, the payload limit of IPv4 UDP
+constexpr std::size_t maximumDatagramSize = 65507;
+
+// Non-blocking UDP socket bound to the loopback interface, through POSIX sockets
+class UdpSocket {
+public:
+    UdpSocket();
+
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Binds to 127.0.0.1:port, any free port if 0
+    // returns true on success, false otherwise
+    bool open(std::uint16_t port = 0);
+
+    void close();
+
+    bool isOpen() const;
+
+    // The address others send to, valid once open
+    UdpAddress address() const;
+
+    // returns true if the whole datagram was sent, false otherwise, e.g. if the socket's buffer is full
+    bool send(const UdpAddress& destination, const void* data, std::size_t size);
+
+    // Takes the oldest pending datagram, truncated to capacity
+    // returns its size, or -1 if none is pending
+    long receive(UdpAddress& source, void* data, std::size_t capacity);
+
+    // Blocks until a datagram is pending or timeoutMilliseconds elapse
+    // returns true if a datagram is pending, false otherwise
+    bool wait(int timeoutMilliseconds);
+
+private:
+    int descriptor;
+    UdpAddress boundAddress;
+};
+
+#endif
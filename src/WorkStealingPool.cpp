@@ -0,0 +1,141 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <utility>
+
+// Pool & index of the worker running on this thread, if any
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local int currentWorker = -1;
+
+WorkStealingPool::WorkStealingPool(unsigned int threadCount)
+    : nextWorker(0),
+      queuedTasks(0),
+      unfinishedTasks(0),
+      stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    // Started once every deque exists, as workers steal from all of them
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers[i]->thread = std::thread(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+
+    {
+        const std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (const auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    // Counted first, so that counters never drop below the tasks a worker might already have taken
+    {
+        const std::lock_guard<std::mutex> lock(stateMutex);
+        queuedTasks++;
+        unfinishedTasks++;
+    }
+
+    const int index = workerIndex();
+    Worker& worker = *workers[index >= 0 ? static_cast<unsigned int>(index)
+                                         : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size()];
+    {
+        const std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allFinished.wait(lock, [this] { return unfinishedTasks == 0; });
+}
+
+unsigned int WorkStealingPool::threadCount() const {
+    return static_cast<unsigned int>(workers.size());
+}
+
+int WorkStealingPool::workerIndex() const {
+    return currentPool == this ? currentWorker : -1;
+}
+
+std::vector<WorkerStatistics> WorkStealingPool::statistics() const {
+    std::vector<WorkerStatistics> result(workers.size());
+    for (std::size_t i = 0; i < workers.size(); i++) {
+        result[i].executed = workers[i]->executed.load(std::memory_order_relaxed);
+        result[i].stolen = workers[i]->stolen.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+bool WorkStealingPool::popOwn(const unsigned int index, Task& task) {
+    Worker& worker = *workers[index];
+    const std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(const unsigned int index, Task& task) {
+    for (std::size_t offset = 1; offset < workers.size(); offset++) {
+        Worker& victim = *workers[(index + offset) % workers.size()];
+        const std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            workers[index]->stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(const unsigned int index) {
+    currentPool = this;
+    currentWorker = static_cast<int>(index);
+
+    while (true) {
+        Task task;
+        if (popOwn(index, task) || steal(index, task)) {
+            {
+                const std::lock_guard<std::mutex> lock(stateMutex);
+                queuedTasks--;
+            }
+
+            task();
+            workers[index]->executed.fetch_add(1, std::memory_order_relaxed);
+
+            bool finished;
+            {
+                const std::lock_guard<std::mutex> lock(stateMutex);
+                finished = --unfinishedTasks == 0;
+            }
+            if (finished) {
+                allFinished.notify_all();
+            }
+            continue;
+        }
+
+        // Tasks counted as queued may still be in flight between a deque and the counter, hence looping to retry
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workAvailable.wait(lock, [this] { return stopping || queuedTasks > 0; });
+        if (stopping && queuedTasks == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef WORK_STEALING_POOL
+#define WORK_STEALING_POOL
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Tasks run and stolen by a worker of a WorkStealingPool
+struct WorkerStatistics {
+    std::uint64_t executed = 0;
+    std::uint64_t stolen = 0;
+};
+
+// Fixed set of worker threads, each with its own deque of tasks
+// Workers run their own tasks newest first, which keeps related work on one thread, and once out of them
+// steal the oldest task of another worker, so that uneven tasks still spread over every thread
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+
+    // 0 threads stands for one per hardware thread
+    explicit WorkStealingPool(unsigned int threadCount = 0);
+
+    // Runs the tasks left, then joins the workers
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+
+    WorkStealingPool& operator =(const WorkStealingPool&) = delete;
+
+    // Thread-safe, task must not throw
+    // Tasks submitted by a worker go to its own deque, others are dealt to the workers in turn
+    void submit(Task task);
+
+    // Blocks until every task submitted so far, and every task they submit, has finished
+    // Must not be called from a worker
+    void wait();
+
+    unsigned int threadCount() const;
+
+    // Index of the calling worker in [0, threadCount), -1 if it is not one of this pool's workers
+    int workerIndex() const;
+
+    std::vector<WorkerStatistics> statistics() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<std::uint64_t> executed{0};
+        std::atomic<std::uint64_t> stolen{0};
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<unsigned int> nextWorker;
+
+    // Guards the counters below, which workers sleep & wait() blocks on
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allFinished;
+    // Submitted tasks not yet taken by a worker
+    std::size_t queuedTasks;
+    // Submitted tasks not yet finished
+    std::size_t unfinishedTasks;
+    bool stopping;
+
+    void run(unsigned int index);
+
+    // Newest task of worker index's own deque
+    bool popOwn(unsigned int index, Task& task);
+
+    // Oldest task of the first other worker which has any, starting after index
+    bool steal(unsigned int index, Task& task);
+};
+
+#endif
@@ -1,29 +1,146 @@
 #include <QtWidgets/QApplication>
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <random>
 #include <string>
 
 #include "Cartesian3.h"
+#include "CommandLine.h"
 #include "FlightSimulatorWidget.h"
+#include "InputRecording.h"
 #include "Scene.h"
+#include "SimulationThread.h"
+#include "TelemetryRing.h"
+#include "TraceEvents.h"
+
+// Written on exit, unless built without ENABLE_PHASE_TIMING
+constexpr const char* defaultPhaseTimingsFileName = "phase-timings.csv";
 
 int main(int argc, char** argv) {
     QApplication application(argc, argv);
 
-    if (argc != 4) {
+    // Replays take the initial coordinates from the recording, so options may come first
+    const int firstOptional = argc > 1 && isOptionName(argv[1]) ? 1 : 4;
+
+    if (!hasWellFormedOptionalParameters(argc, argv, firstOptional)) {
+        std::cerr << "Application should receive 3 parameters specifying initial (x, y, z) coordinates" << std::endl;
+        std::cerr << "Optionally followed by: --frame-budget <milliseconds>, --obstacles <.obs file>, "
+                  << "--seed <n>, --aircraft <n>, --record <file>, --phase-timings <.csv file>, --trace <.json file>, "
+                  << "--telemetry <shared memory name>" << std::endl;
+        std::cerr << "Or replay a recording with: --replay <file>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const char* replayFileName = optionalParameter(argc, argv, firstOptional, "replay");
+    const char* recordFileName = optionalParameter(argc, argv, firstOptional, "record");
+    const char* seedParameter = optionalParameter(argc, argv, firstOptional, "seed");
+    const char* obstacleFileName = optionalParameter(argc, argv, firstOptional, "obstacles");
+    const char* aircraftParameter = optionalParameter(argc, argv, firstOptional, "aircraft");
+    const char* traceFileName = optionalParameter(argc, argv, firstOptional, "trace");
+    const char* telemetryName = optionalParameter(argc, argv, firstOptional, "telemetry");
+
+    if (!replayFileName && firstOptional == 1) {
         std::cerr << "Application should receive 3 parameters specifying initial (x, y, z) coordinates" << std::endl;
         return EXIT_FAILURE;
     }
 
     try {
-        const Cartesian3 initialPosition(atof(argv[1]), atof(argv[2]), atof(argv[3]));
-        Scene scene(initialPosition);
+        InputReplay replay;
+        RecordingHeader header;
+
+        if (replayFileName) {
+            if (!replay.readRecordingFile(replayFileName)) {
+                std::cerr << "Unable to read recording " << replayFileName << std::endl;
+                return EXIT_FAILURE;
+            }
+            header = replay.header;
+        } else {
+            header.seed = seedParameter ? std::strtoul(seedParameter, nullptr, 10) : std::random_device()();
+            header.timeStep = simulationTimeStep;
+            header.initialPosition = Cartesian3(atof(argv[1]), atof(argv[2]), atof(argv[3]));
+            header.obstacleFileName = obstacleFileName ? obstacleFileName : "";
+            header.aircraftCount = aircraftParameter ? std::strtoul(aircraftParameter, nullptr, 10) : 0;
+        }
+
+        std::cout << "Seed: " << header.seed << std::endl;
+
+        // Before loading, so that asset loads are part of the timeline
+        if (traceFileName) {
+            setTraceThreadName("main");
+            startTracing();
+        }
+
+        Scene scene(header.initialPosition,
+                    header.obstacleFileName.empty() ? nullptr : header.obstacleFileName.c_str(), header.seed);
+        scene.spawnAircraft(header.aircraftCount);
 
-        FlightSimulatorWidget flightWindow(nullptr, &scene);
+        std::cout << "Assets loaded:" << std::endl;
+        scene.assets->printLoadTimes(std::cout);
+
+        const char* frameBudget = optionalParameter(argc, argv, firstOptional, "frame-budget");
+
+        InputRecorder recorder;
+        TelemetryPublisher telemetry;
+
+        // Declared after scene, recorder and telemetry so that it stops before they are destroyed
+        SimulationThread simulation(scene, header.timeStep);
+
+        if (replayFileName) {
+            simulation.replay(replay);
+        } else if (recordFileName) {
+            if (!recorder.open(recordFileName, header)) {
+                std::cerr << "Unable to write recording " << recordFileName << std::endl;
+                return EXIT_FAILURE;
+            }
+            simulation.record(recorder);
+        }
+
+        if (telemetryName) {
+            if (!telemetry.open(telemetryName)) {
+                std::cerr << "Unable to create telemetry shared memory " << telemetryName << std::endl;
+                return EXIT_FAILURE;
+            }
+            simulation.publishTelemetry(telemetry);
+        }
+
+        FlightSimulatorWidget flightWindow(nullptr, &scene, &simulation,
+                                           frameBudget ? atof(frameBudget) : defaultFrameBudget);
         flightWindow.resize(1200, 675);
         flightWindow.show();
 
-        return application.exec();
+        simulation.start();
+
+        const int status = application.exec();
+
+        // Phase timings are only safe to read once the simulation is done writing them
+        simulation.stop();
+
+        if (flightWindow.inputLatency.recorded(0) > 0) {
+            const PhaseSummary latency = flightWindow.inputLatency.summarize(0);
+            std::cout << "Input latency over the last " << std::min<unsigned long>(
+                             flightWindow.inputLatency.recorded(0), phaseTimingWindow)
+                      << " key presses: min " << latency.minimum << " ms, average " << latency.average
+                      << " ms, p99 " << latency.p99 << " ms" << std::endl;
+        }
+#ifdef ENABLE_PHASE_TIMING
+        const char* phaseTimingsFileName = optionalParameter(argc, argv, firstOptional, "phase-timings");
+        if (!phaseTimingsFileName) {
+            phaseTimingsFileName = defaultPhaseTimingsFileName;
+        }
+        if (!scene.writePhaseTimingsFile(phaseTimingsFileName)) {
+            std::cerr << "Unable to write phase timings to " << phaseTimingsFileName << std::endl;
+        }
+#endif
+
+        if (traceFileName) {
+            stopTracing();
+            if (!writeTraceFile(traceFileName)) {
+                std::cerr << "Unable to write trace to " << traceFileName << std::endl;
+            }
+        }
+
+        return status;
     } catch (std::string errorString) {
         std::cout << "Unable to run application." << errorString << std::endl;
         return EXIT_FAILURE;
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "CommandLine.h"
+#include "TelemetryRing.h"
+
+/*
+ * Follows the telemetry ring of a running basic-flight or basic-flight-headless started with --telemetry <name>,
+ * printing every few ticks, until no record is published for a while.
+ * Records are read straight from the shared memory the simulation writes to, without any system call per record.
+ */
+
+constexpr unsigned long defaultEvery = 60;
+constexpr double defaultIdleSeconds = 2.0;
+
+// Between polls of the ring, a fraction of a tick at 60 Hz
+constexpr std::chrono::milliseconds pollInterval(2);
+
+typedef std::chrono::steady_clock Clock;
+
+void printUsage() {
+    std::cerr << "Usage: telemetry-reader <name> [options]" << std::endl;
+    std::cerr << "  --every <n>            prints one record every n ticks (default: " << defaultEvery << ")"
+            << std::endl;
+    std::cerr << "  --idle-seconds <s>     exits once nothing was published for this long (default: "
+            << defaultIdleSeconds << ")" << std::endl;
+}
+
+void printRecord(const TelemetryRecord& record) {
+    float updateTime = 0.0f;
+    for (const float phaseTime : record.updatePhaseTimes) {
+        updateTime += phaseTime;
+    }
+
+    std::cout << std::setw(8) << record.tick << std::setw(10) << record.simulationTime
+              << std::setw(12) << record.planePosition[0] << std::setw(12) << record.planePosition[1]
+              << std::setw(10) << record.planePosition[2]
+              << std::setw(8) << record.planeRotation[1] << std::setw(8) << record.planeRotation[4]
+              << std::setw(8) << record.planeRotation[7]
+              << std::setw(8) << record.flightSpeed << std::setw(8) << record.liveLavaBombs
+              << std::setw(10) << record.aircraft << std::setw(12) << 1e3f * updateTime << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || isOptionName(argv[1]) || !hasWellFormedOptionalParameters(argc, argv, 2)) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    const char* everyParameter = optionalParameter(argc, argv, 2, "every");
+    const char* idleParameter = optionalParameter(argc, argv, 2, "idle-seconds");
+    const unsigned long every = std::max<unsigned long>(everyParameter ? std::strtoul(everyParameter, nullptr, 10)
+                                                                       : defaultEvery, 1);
+    const double idleSeconds = idleParameter ? std::atof(idleParameter) : defaultIdleSeconds;
+
+    TelemetryReader reader;
+    if (!reader.open(argv[1])) {
+        std::cerr << "Unable to open telemetry shared memory " << argv[1]
+                  << ", is a simulation publishing to it?" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Following " << argv[1] << ", " << reader.capacity() << " records" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(8) << "tick" << std::setw(10) << "time s" << std::setw(12) << "x" << std::setw(12) << "y"
+              << std::setw(10) << "z" << std::setw(8) << "fwd x" << std::setw(8) << "fwd y" << std::setw(8) << "fwd z"
+              << std::setw(8) << "speed" << std::setw(8) << "bombs" << std::setw(10) << "aircraft"
+              << std::setw(12) << "update us" << std::endl;
+
+    // Only records published from now on
+    std::uint64_t next = reader.published();
+    unsigned long nRead = 0;
+    unsigned long nMissed = 0;
+    Clock::time_point lastRecord = Clock::now();
+
+    while (std::chrono::duration<double>(Clock::now() - lastRecord).count() < idleSeconds) {
+        const std::uint64_t published = reader.published();
+        if (published != next) {
+            lastRecord = Clock::now();
+        }
+
+        // Records the publisher already overwrote are lost, skip to the oldest one left
+        if (published - next > reader.capacity()) {
+            nMissed += published - reader.capacity() - next;
+            next = published - reader.capacity();
+        }
+
+        for (TelemetryRecord record{}; next < published; next++) {
+            if (!reader.read(next, record)) {
+                nMissed++;
+                continue;
+            }
+            nRead++;
+            if (record.tick % every == 0) {
+                printRecord(record);
+            }
+        }
+
+        std::this_thread::sleep_for(pollInterval);
+    }
+
+    std::cout << "Read " << nRead << " records, missed " << nMissed << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,14 @@
+TEMPLATE = app
+CONFIG += console release c++17
+CONFIG -= qt app_bundle
+# shm_open lives in librt on older glibc
+LIBS += -lrt
+TARGET = ../bin/telemetry-reader
+INCLUDEPATH += ../src
+OBJECTS_DIR = ../build/telemetry-reader/obj
+
+# Input
+SOURCES += TelemetryReaderExample.cpp \
+           ../src/Cartesian3.cpp \
+           ../src/CommandLine.cpp \
+           ../src/TelemetryRing.cpp